@@ -7,6 +7,8 @@ public class MONA_API_Leaderboard : ModuleRules
 	public MONA_API_Leaderboard(ReadOnlyTargetRules Target) : base(Target)
 	{
 		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+		//LeaderboardCoroutines.h needs <coroutine>
+		CppStandard = CppStandardVersion.Cpp20;
 		
 		PublicIncludePaths.AddRange(
 			new string[] {
@@ -25,13 +27,13 @@ public class MONA_API_Leaderboard : ModuleRules
 		PublicDependencyModuleNames.AddRange(
 			new string[]
 			{
-				"Core", "InputCore", "HTTP", "Json", "JsonUtilities", "SSL"
+				"Core", "CoreUObject", "Engine", "InputCore", "HTTP", "Json", "JsonUtilities", "SSL", "NetCore"
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
 
-		//Add OpenSSL
-		if (Target.Platform == UnrealTargetPlatform.Win64)
+		//Add OpenSSL. Linux is needed for headless automation running recorded traffic
+		if (Target.Platform == UnrealTargetPlatform.Win64 || Target.Platform == UnrealTargetPlatform.Linux)
 		{
 			AddEngineThirdPartyPrivateStaticDependencies(Target, "OpenSSL");
 		}
@@ -40,10 +42,9 @@ public class MONA_API_Leaderboard : ModuleRules
 		PrivateDependencyModuleNames.AddRange(
 			new string[]
 			{
-				"CoreUObject",
-				"Engine",
 				"Slate",
 				"SlateCore",
+				"WebSockets",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
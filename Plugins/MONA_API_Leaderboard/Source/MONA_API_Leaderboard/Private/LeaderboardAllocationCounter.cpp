@@ -0,0 +1,197 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardAllocationCounter.h"
+#include "HAL/MemoryBase.h"
+#include <atomic>
+
+namespace LeaderboardAllocationCounter
+{
+	//Totals of one thread, only touched by that thread. Plain integers, so they need no allocation to set up
+	struct FThreadCounts
+	{
+		int64 NumAllocations = 0;
+		int64 AllocatedBytes = 0;
+		int64 LiveBytes = 0;
+		int64 PeakBytes = 0;
+		int32 ScopeDepth = 0;
+	};
+	static thread_local FThreadCounts ThreadCounts;
+
+	//Forwards everything to the allocator it replaced, counting on the way while enabled and inside a scope
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInner)
+			: Inner(InInner)
+		{
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			void* Ptr = Inner->Malloc(Count, Alignment);
+			Added(Ptr);
+			return Ptr;
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			void* Ptr = Inner->TryMalloc(Count, Alignment);
+			Added(Ptr);
+			return Ptr;
+		}
+
+		//A resize counts as a new allocation, as it does for the caller
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			Removed(Original);
+			void* Ptr = Inner->Realloc(Original, Count, Alignment);
+			Added(Ptr);
+			return Ptr;
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			const int64 OriginalSize = IsCounting() ? SizeOf(Original) : 0;
+			void* Ptr = Inner->TryRealloc(Original, Count, Alignment);
+			//A failed resize leaves the original in place
+			if (Ptr != nullptr || Count == 0)
+			{
+				ThreadCounts.LiveBytes -= OriginalSize;
+				Added(Ptr);
+			}
+			return Ptr;
+		}
+
+		virtual void Free(void* Original) override
+		{
+			Removed(Original);
+			Inner->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+		FMalloc* Inner;
+		std::atomic<bool> bCounting{false};
+
+	private:
+		bool IsCounting() const
+		{
+			return ThreadCounts.ScopeDepth > 0 && bCounting.load(std::memory_order_relaxed);
+		}
+
+		int64 SizeOf(void* Ptr) const
+		{
+			SIZE_T Size = 0;
+			return Ptr && Inner->GetAllocationSize(Ptr, Size) ? static_cast<int64>(Size) : 0;
+		}
+
+		void Added(void* Ptr)
+		{
+			if (Ptr == nullptr || !IsCounting()) return;
+			const int64 Size = SizeOf(Ptr);
+			FThreadCounts& Counts = ThreadCounts;
+			Counts.NumAllocations++;
+			Counts.AllocatedBytes += Size;
+			Counts.LiveBytes += Size;
+			Counts.PeakBytes = FMath::Max(Counts.PeakBytes, Counts.LiveBytes);
+		}
+
+		//Blocks from before the scope or from other threads are subtracted too, so live bytes can drop below where
+		//they started
+		void Removed(void* Ptr)
+		{
+			if (Ptr == nullptr || !IsCounting()) return;
+			ThreadCounts.LiveBytes -= SizeOf(Ptr);
+		}
+	};
+
+	//Allocated with the system allocator (FMalloc derives from FUseSystemMallocForNew) and never freed: another
+	//thread may still be inside it
+	static FCountingMalloc* Proxy = nullptr;
+	static bool bSizesKnown = false;
+}
+
+bool FLeaderboardAllocationCounter::Install()
+{
+	using namespace LeaderboardAllocationCounter;
+	if (Proxy == nullptr)
+	{
+		check(GMalloc != nullptr);
+		Proxy = new FCountingMalloc(GMalloc);
+		void* Probe = Proxy->Inner->Malloc(16, DEFAULT_ALIGNMENT);
+		SIZE_T Size = 0;
+		bSizesKnown = Proxy->Inner->GetAllocationSize(Probe, Size);
+		Proxy->Inner->Free(Probe);
+		FPlatformAtomics::InterlockedExchangePtr(reinterpret_cast<void**>(&GMalloc), Proxy);
+	}
+	Proxy->bCounting = true;
+	if (!bSizesKnown)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s does not report block sizes, only allocations are counted"), Proxy->Inner->GetDescriptiveName());
+	}
+	return bSizesKnown;
+}
+
+void FLeaderboardAllocationCounter::Uninstall()
+{
+	using namespace LeaderboardAllocationCounter;
+	if (Proxy)
+	{
+		Proxy->bCounting = false;
+	}
+}
+
+bool FLeaderboardAllocationCounter::IsInstalled()
+{
+	using namespace LeaderboardAllocationCounter;
+	return Proxy && Proxy->bCounting;
+}
+
+FLeaderboardAllocationCounter::FScope::FScope()
+{
+	using namespace LeaderboardAllocationCounter;
+	FThreadCounts& Counts = ThreadCounts;
+	StartAllocations = Counts.NumAllocations;
+	StartAllocatedBytes = Counts.AllocatedBytes;
+	StartLiveBytes = Counts.LiveBytes;
+	EnclosingPeakBytes = Counts.PeakBytes;
+	Counts.PeakBytes = StartLiveBytes;
+	Counts.ScopeDepth++;
+}
+
+FLeaderboardAllocationCounter::FScope::~FScope()
+{
+	using namespace LeaderboardAllocationCounter;
+	FThreadCounts& Counts = ThreadCounts;
+	Counts.ScopeDepth--;
+	Counts.PeakBytes = FMath::Max(EnclosingPeakBytes, Counts.PeakBytes);
+}
+
+int64 FLeaderboardAllocationCounter::FScope::GetNumAllocations() const
+{
+	using namespace LeaderboardAllocationCounter;
+	return ThreadCounts.NumAllocations - StartAllocations;
+}
+
+int64 FLeaderboardAllocationCounter::FScope::GetAllocatedBytes() const
+{
+	using namespace LeaderboardAllocationCounter;
+	return ThreadCounts.AllocatedBytes - StartAllocatedBytes;
+}
+
+int64 FLeaderboardAllocationCounter::FScope::GetPeakBytes() const
+{
+	using namespace LeaderboardAllocationCounter;
+	return FMath::Max<int64>(0, ThreadCounts.PeakBytes - StartLiveBytes);
+}
@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardAsyncActions.h"
+#include "LeaderboardSession.h"
+#include "Containers/Ticker.h"
+
+namespace
+{
+	ULeaderboardSession* ResolveSession(ULeaderboardSession* Session)
+	{
+		return Session ? Session : ULeaderboardController::GetLeaderboardController()->GetDefaultSession();
+	}
+
+	//Shared by every copy of a node's completion callback. A cancelled request (CancelRequest, CancelAll) never calls
+	//back, so if the last copy is dropped without having run, OnDropped finishes the node instead.
+	//The last copy goes away while the scheduler is still removing it from its queues, or during GC when the
+	//controller is destroyed, so OnDropped runs on the next tick rather than from the destructor
+	class FCompletionGuard
+	{
+	public:
+		explicit FCompletionGuard(TFunction<void()>&& InOnDropped)
+			: OnDropped(MoveTemp(InOnDropped))
+		{
+		}
+
+		~FCompletionGuard()
+		{
+			if (OnDropped)
+			{
+				FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([OnDropped = MoveTemp(OnDropped)](float DeltaTime)
+				{
+					OnDropped();
+					return false;
+				}));
+			}
+		}
+
+		void MarkRun() { OnDropped.Reset(); }
+
+	private:
+		TFunction<void()> OnDropped;
+	};
+
+	//Fail(Action) fires the node's failure pin, the node is released afterwards
+	template<typename ActionType, typename FailType>
+	TSharedRef<FCompletionGuard> MakeCompletionGuard(ActionType* Action, FailType&& Fail)
+	{
+		return MakeShared<FCompletionGuard>([WeakAction = TWeakObjectPtr<ActionType>(Action), Fail = Forward<FailType>(Fail)]()
+		{
+			if (ActionType* This = WeakAction.Get())
+			{
+				Fail(This);
+				This->SetReadyToDestroy();
+			}
+		});
+	}
+}
+
+UGetTopScoresAsyncAction* UGetTopScoresAsyncAction::GetTopScoresAsync(UObject* WorldContextObject, const FLeaderboardQuery& Query)
+{
+	UGetTopScoresAsyncAction* Action = NewObject<UGetTopScoresAsyncAction>();
+	Action->Query = Query;
+	//Keeps the node alive until it has called back
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UGetTopScoresAsyncAction::Activate()
+{
+	TSharedRef<FCompletionGuard> Guard = MakeCompletionGuard(this, [](UGetTopScoresAsyncAction* This) { This->OnFailure.Broadcast(FScores()); });
+	ULeaderboardController::GetLeaderboardController()->GetTopScoresAsync(Query, [WeakThis = TWeakObjectPtr<UGetTopScoresAsyncAction>(this), Guard](bool bSuccess, const FScores& Scores)
+	{
+		Guard->MarkRun();
+		if (UGetTopScoresAsyncAction* This = WeakThis.Get())
+		{
+			(bSuccess ? This->OnSuccess : This->OnFailure).Broadcast(Scores);
+			This->SetReadyToDestroy();
+		}
+	});
+}
+
+UGetTopScoresMultiAsyncAction* UGetTopScoresMultiAsyncAction::GetTopScoresMultiAsync(UObject* WorldContextObject, const TArray<FLeaderboardQuery>& Queries, float TimeoutSeconds)
+{
+	UGetTopScoresMultiAsyncAction* Action = NewObject<UGetTopScoresMultiAsyncAction>();
+	Action->Queries = Queries;
+	Action->TimeoutSeconds = TimeoutSeconds;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UGetTopScoresMultiAsyncAction::Activate()
+{
+	TSharedRef<FCompletionGuard> Guard = MakeCompletionGuard(this, [](UGetTopScoresMultiAsyncAction* This) { This->OnFailure.Broadcast(FLeaderboardMultiResult()); });
+	ULeaderboardController::GetLeaderboardController()->GetTopScoresMultiAsync(Queries, [WeakThis = TWeakObjectPtr<UGetTopScoresMultiAsyncAction>(this), Guard](const FLeaderboardMultiResult& Result)
+	{
+		Guard->MarkRun();
+		if (UGetTopScoresMultiAsyncAction* This = WeakThis.Get())
+		{
+			(Result.bComplete ? This->OnSuccess : This->OnFailure).Broadcast(Result);
+			This->SetReadyToDestroy();
+		}
+	}, TimeoutSeconds);
+}
+
+UPostScoreAsyncAction* UPostScoreAsyncAction::PostScoreAsync(UObject* WorldContextObject, ULeaderboardSession* Session, float Score, const FString& Topic)
+{
+	UPostScoreAsyncAction* Action = NewObject<UPostScoreAsyncAction>();
+	Action->Session = ResolveSession(Session);
+	Action->Score = Score;
+	Action->Topic = Topic;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UPostScoreAsyncAction::Activate()
+{
+	TSharedRef<FCompletionGuard> Guard = MakeCompletionGuard(this, [](UPostScoreAsyncAction* This) { This->OnFailure.Broadcast(); });
+	Session->PostScoreAsync(Score, Topic, FOnScorePostComplete([WeakThis = TWeakObjectPtr<UPostScoreAsyncAction>(this), Guard](ELeaderboardPostResult Result)
+	{
+		Guard->MarkRun();
+		if (UPostScoreAsyncAction* This = WeakThis.Get())
+		{
+			(Result == ELeaderboardPostResult::Posted ? This->OnSuccess : Result == ELeaderboardPostResult::Skipped ? This->OnSkipped : This->OnFailure).Broadcast();
+			This->SetReadyToDestroy();
+		}
+	}));
+}
+
+UGenerateOTPAsyncAction* UGenerateOTPAsyncAction::GenerateOTPAsync(UObject* WorldContextObject, ULeaderboardSession* Session, const FString& Email)
+{
+	UGenerateOTPAsyncAction* Action = NewObject<UGenerateOTPAsyncAction>();
+	Action->Session = ResolveSession(Session);
+	Action->Email = Email;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UGenerateOTPAsyncAction::Activate()
+{
+	TSharedRef<FCompletionGuard> Guard = MakeCompletionGuard(this, [](UGenerateOTPAsyncAction* This) { This->OnFailure.Broadcast(); });
+	Session->GenerateOTPAsync(Email, [WeakThis = TWeakObjectPtr<UGenerateOTPAsyncAction>(this), Guard](bool bSuccess)
+	{
+		Guard->MarkRun();
+		if (UGenerateOTPAsyncAction* This = WeakThis.Get())
+		{
+			(bSuccess ? This->OnSuccess : This->OnFailure).Broadcast();
+			This->SetReadyToDestroy();
+		}
+	});
+}
+
+UVerifyOTPAsyncAction* UVerifyOTPAsyncAction::VerifyOTPAsync(UObject* WorldContextObject, ULeaderboardSession* Session, const FString& Email, const FString& OTP)
+{
+	UVerifyOTPAsyncAction* Action = NewObject<UVerifyOTPAsyncAction>();
+	Action->Session = ResolveSession(Session);
+	Action->Email = Email;
+	Action->OTP = OTP;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UVerifyOTPAsyncAction::Activate()
+{
+	TSharedRef<FCompletionGuard> Guard = MakeCompletionGuard(this, [](UVerifyOTPAsyncAction* This) { This->OnFailure.Broadcast(); });
+	Session->VerifyOTPAsync(Email, OTP, [WeakThis = TWeakObjectPtr<UVerifyOTPAsyncAction>(this), Guard](bool bSuccess)
+	{
+		Guard->MarkRun();
+		if (UVerifyOTPAsyncAction* This = WeakThis.Get())
+		{
+			(bSuccess ? This->OnSuccess : This->OnFailure).Broadcast();
+			This->SetReadyToDestroy();
+		}
+	});
+}
+
+UGetUserAsyncAction* UGetUserAsyncAction::GetUserAsync(UObject* WorldContextObject, ULeaderboardSession* Session)
+{
+	UGetUserAsyncAction* Action = NewObject<UGetUserAsyncAction>();
+	Action->Session = ResolveSession(Session);
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UGetUserAsyncAction::Activate()
+{
+	TSharedRef<FCompletionGuard> Guard = MakeCompletionGuard(this, [](UGetUserAsyncAction* This) { This->OnFailure.Broadcast(FUser()); });
+	Session->GetUserAsync([WeakThis = TWeakObjectPtr<UGetUserAsyncAction>(this), Guard](bool bSuccess, const FUser& User)
+	{
+		Guard->MarkRun();
+		if (UGetUserAsyncAction* This = WeakThis.Get())
+		{
+			(bSuccess ? This->OnSuccess : This->OnFailure).Broadcast(User);
+			This->SetReadyToDestroy();
+		}
+	});
+}
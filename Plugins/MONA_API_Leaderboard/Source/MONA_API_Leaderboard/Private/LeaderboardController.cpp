@@ -1,6 +1,16 @@
 
 #include "LeaderboardController.h"
+#include "LeaderboardSession.h"
+#include "LeaderboardPromise.h"
+#include "LeaderboardExport.h"
+#include "LeaderboardDiagnostics.h"
+#include "LeaderboardJsonParse.h"
+#include "Misc/StringBuilder.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "HAL/IConsoleManager.h"
 #include "http.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
 #include "Serialization/JsonSerializer.h"
 #include "JsonObjectConverter.h"
 #include "EngineGlobals.h"
@@ -13,17 +23,91 @@ THIRD_PARTY_INCLUDES_START
 THIRD_PARTY_INCLUDES_END
 #undef UI
 #include "Misc/Base64.h"
-#include "Async/Async.h"
+#include "WebSocketsModule.h"
+#include "IWebSocket.h"
 
 //Singleton
 ULeaderboardController* ULeaderboardController::Instance = nullptr;
 
+//State of one GetTopScoresMulti call, shared by its requests and its deadline
+struct FLeaderboardMultiFetch
+{
+	FLeaderboardMultiResult Result;
+	FOnTopScoresMultiComplete OnComplete;
+	//Per board, valid while its request is queued or in flight
+	TArray<FLeaderboardRequestHandle> Handles;
+	FLeaderboardRequestHandle BatchHandle;
+	int32 NextIndex = 0;
+	int32 NumOutstanding = 0;
+	FTSTicker::FDelegateHandle DeadlineHandle;
+	bool bDelivered = false;
+};
+
+//Stats and budgets for headless automation, e.g. -ExecCmds="Mona.Leaderboard.Stats.Budget RefreshToken Requests=1"
+static FAutoConsoleCommand CmdLeaderboardStats(
+	TEXT("Mona.Leaderboard.Stats"),
+	TEXT("Print per-endpoint request counts, response sizes and game-thread handler time"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		ULeaderboardController::GetLeaderboardController()->GetScheduler().GetStats().Dump();
+	}));
+
+static FAutoConsoleCommand CmdLeaderboardStatsReset(
+	TEXT("Mona.Leaderboard.Stats.Reset"),
+	TEXT("Reset the leaderboard stats"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		ULeaderboardController::GetLeaderboardController()->GetScheduler().GetStats().Reset();
+	}));
+
+static FAutoConsoleCommand CmdLeaderboardMemory(
+	TEXT("Mona.Leaderboard.Memory"),
+	TEXT("Mona.Leaderboard.Memory [BudgetKB]. Print leaderboard memory use per pool, optionally changing the budget first"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FLeaderboardMemoryBudget& Budget = ULeaderboardController::GetLeaderboardController()->GetMemoryBudget();
+		if (Args.Num() > 0)
+		{
+			Budget.SetBudgetBytes(FCString::Atoi64(*Args[0]) * 1024);
+		}
+		Budget.Dump();
+	}));
+
+static FAutoConsoleCommand CmdLeaderboardExport(
+	TEXT("Mona.Leaderboard.Export"),
+	TEXT("Mona.Leaderboard.Export <File>. Write every cached board to a columnar board file"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() == 0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Mona.Leaderboard.Export: no file given"));
+			return;
+		}
+		ULeaderboardController::GetLeaderboardController()->ExportCachedScores(Args[0]);
+	}));
+
+static FAutoConsoleCommand CmdLeaderboardStatsBudget(
+	TEXT("Mona.Leaderboard.Stats.Budget"),
+	TEXT("Mona.Leaderboard.Stats.Budget <Endpoint> [Requests=N] [GameThreadMs=X] [Bytes=N] [AllocatedKB=N]. Logs an error for every exceeded limit, AllocatedKB needs the allocation counter installed"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		ELeaderboardEndpoint Endpoint;
+		if (Args.Num() == 0 || !LexTryParseString(Endpoint, *Args[0]))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Mona.Leaderboard.Stats.Budget: unknown endpoint '%s'"), Args.Num() > 0 ? *Args[0] : TEXT(""));
+			return;
+		}
+		const FLeaderboardOperationBudget Budget = FLeaderboardOperationBudget::Parse(*FString::Join(Args, TEXT(" ")));
+		ULeaderboardController::GetLeaderboardController()->GetScheduler().GetStats().CheckBudget(Endpoint, Budget);
+	}));
+
 ULeaderboardController* ULeaderboardController::GetLeaderboardController()
 {
 	//Create LeaderboardController Singleton if it does not exist already
 	if (Instance == nullptr)
 	{
 		Instance = NewObject<ULeaderboardController>();
+		Instance->ApplyCommandLine();
 	}
 	return Instance;
 }
@@ -31,97 +115,55 @@ ULeaderboardController* ULeaderboardController::GetLeaderboardController()
 void ULeaderboardController::ServerSetSDKSecret_Implementation(const FString& InSDKSecret)
 {
 	SDKSecret = InSDKSecret;
+	PublishConfig();
 }
 
-void ULeaderboardController::GenerateOTP(const FString& Email)
+ULeaderboardSession* ULeaderboardController::CreateSession(const FString& PlayerID)
 {
-	if (!ValidAppID()) return;
-	//Setup Request Body	
-	TSharedRef<FJsonObject> RequestObj = MakeShared<FJsonObject>();
-	RequestObj->SetStringField("email", Email);
-	FString RequestBody;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBody);
-	FJsonSerializer::Serialize(RequestObj, Writer);
-	
-	//Setup Request
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-	Request->SetVerb("POST");
-	//Bind Response Received Callback
-	Request->OnProcessRequestComplete().BindUObject(this, &ULeaderboardController::GenerateOTPResponseReceived);
-	//Format API call
-	Request->SetURL("https://api.monaverse.com/public/auth/otp/generate");
-	//Set Header Info
-	Request->SetHeader("X-Mona-Application-Id", ApplicationID);
-	Request->AppendToHeader("content-type", "application/json");
-	//Set Request Body
-	Request->SetContentAsString(RequestBody);
-
-	Request->ProcessRequest();
+	if (ULeaderboardSession* Existing = FindSession(PlayerID))
+	{
+		return Existing;
+	}
+	ULeaderboardSession* Session = NewObject<ULeaderboardSession>(this);
+	Session->Initialize(PlayerID);
+	Sessions.Add(PlayerID, Session);
+	return Session;
 }
 
-void ULeaderboardController::VerifyOTP(const FString& Email, const FString& OTP)
+ULeaderboardSession* ULeaderboardController::FindSession(const FString& PlayerID) const
 {
-	//return if invalid App ID or empty OTP
-	if (!ValidAppID()) return;
-	if (OTP.IsEmpty()) return;
-	//Setup Request Body	
-	TSharedRef<FJsonObject> RequestObj = MakeShared<FJsonObject>();
-	RequestObj->SetStringField("email", Email);
-	RequestObj->SetStringField("otp", OTP);
-	FString RequestBody;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBody);
-	FJsonSerializer::Serialize(RequestObj, Writer);
-	
-	//Setup Request
-	FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
-	Request->SetVerb("POST");
-	//Bind Response Received Callback
-	Request->OnProcessRequestComplete().BindUObject(this, &ULeaderboardController::VerifyOTPResponseReceived);
-	//Format API call
-	Request->SetURL("https://api.monaverse.com/public/auth/otp/verify");
-	//Set Header Info
-	Request->SetHeader("X-Mona-Application-Id", ApplicationID);
-	Request->AppendToHeader("content-type", "application/json");
-	//Set Request Body
-	Request->SetContentAsString(RequestBody);
+	const TObjectPtr<ULeaderboardSession>* Session = Sessions.Find(PlayerID);
+	return Session ? Session->Get() : nullptr;
+}
 
-	Request->ProcessRequest();
+void ULeaderboardController::RemoveSession(const FString& PlayerID)
+{
+	Sessions.Remove(PlayerID);
 }
 
-void ULeaderboardController::RefreshAccessToken_Implementation()
+ULeaderboardSession* ULeaderboardController::GetDefaultSession()
 {
-	std::lock_guard Lock(Mutex);
-	if (!ValidAppID() || !ValidAuthorization()) return;
-	TSharedRef<FJsonObject> RequestObj = MakeShared<FJsonObject>();
-	RequestObj->SetStringField("refresh", RefreshToken);
-	FString RequestBody;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBody);
-	FJsonSerializer::Serialize(RequestObj, Writer);
-	TSharedPtr<FHttpResponsePtr> TokenResponse = MakeShared<FHttpResponsePtr>();
-	//Setup Request
-	FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
-	Request->SetVerb("POST");
-	//Bind Response Received Callback
-	Request->OnProcessRequestComplete().BindLambda([&](FHttpRequestPtr, FHttpResponsePtr Response, bool bWasSuccessful)
+	if (DefaultSession == nullptr)
 	{
-		if (bWasSuccessful && Response.IsValid() && Response->GetResponseCode() == 200)
-		{
-			FString ResponseString = Response->GetContentAsString();
-			TSharedPtr<FJsonObject> JsonObject;
-			TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(ResponseString);
+		DefaultSession = NewObject<ULeaderboardSession>(this);
+		DefaultSession->Initialize(FString());
+	}
+	return DefaultSession;
+}
 
-			if (FJsonSerializer::Deserialize(JsonReader, JsonObject) && JsonObject.IsValid())
-			{
-				AccessToken = JsonObject->GetStringField("access");
-			}
-		}
-	});
-	FString url = TEXT("https://api.monaverse.com/public/auth/token/refresh");
-	Request->SetURL(url);
-	Request->SetContentAsString(RequestBody);
-	Request->SetHeader("X-Mona-Application-Id", ApplicationID);
+void ULeaderboardController::GenerateOTP(const FString& Email)
+{
+	GetDefaultSession()->GenerateOTP(Email);
+}
 
-	Request->ProcessRequest();
+void ULeaderboardController::VerifyOTP(const FString& Email, const FString& OTP)
+{
+	GetDefaultSession()->VerifyOTP(Email, OTP);
+}
+
+void ULeaderboardController::RefreshAccessToken_Implementation()
+{
+	GetDefaultSession()->RefreshAccessToken();
 }
 
 /* void ULeaderboardController::GetTopScores()
@@ -145,7 +187,7 @@ void ULeaderboardController::RefreshAccessToken_Implementation()
 
 
 
-void ULeaderboardController::GetTopScores(
+FLeaderboardRequestHandle ULeaderboardController::GetTopScores(
     bool featured, 
     FString topic, 
     ELeaderboardPeriod period, 
@@ -154,312 +196,1158 @@ void ULeaderboardController::GetTopScores(
     FString endTime, 
     bool includeAllUsersScores)
 {
-    if (!ValidAppID()) return;
-    
-    // Setup Request
-    FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
-    Request->SetVerb("GET");
-    
-    // Bind Response Received Callback
-    Request->OnProcessRequestComplete().BindUObject(this, &ULeaderboardController::TopScoresResponseReceived);
-    
-    // Format API call
-    FString url = FString::Printf(TEXT("https://api.monaverse.com/public/leaderboards/%s/top-scores"), *ApplicationID);
-    
-    TArray<FString> QueryParams;
-    
-    // Append optional parameters
-    if (featured)
-    {
-        QueryParams.Add(FString("featured=true"));
-    }
-    if (!topic.IsEmpty())
-    {
-        QueryParams.Add(FString::Printf(TEXT("topic=%s"), *topic));
-    }
-    switch (period)
-    {
-        case ELeaderboardPeriod::daily:
-            QueryParams.Add(FString("period=daily"));
-            break;
-        case ELeaderboardPeriod::weekly:
-            QueryParams.Add(FString("period=weekly"));
-            break;
-        case ELeaderboardPeriod::monthly:
-            QueryParams.Add(FString("period=monthly"));
-            break;
-        case ELeaderboardPeriod::all_time:
-            QueryParams.Add(FString("period=all_time"));
-            break;
-    }
-    switch (order)
-    {
-        case ELeaderboardSortingOrder::highest:
-            QueryParams.Add(FString("order=highest"));
-            break;
-        case ELeaderboardSortingOrder::lowest:
-            QueryParams.Add(FString("order=lowest"));
-            break;
-    }
-    if (!startTime.IsEmpty())
+    FLeaderboardQuery Query;
+    Query.bFeatured = featured;
+    Query.Topic = topic;
+    Query.Period = period;
+    Query.Order = order;
+    Query.StartTime = startTime;
+    Query.EndTime = endTime;
+    Query.bIncludeAllUsersScores = includeAllUsersScores;
+
+    // Every call is a navigation, it teaches the prefetcher where players go next
+    NavigationModel.Record(GetViewKey(Query), Query);
+    const FString URL = BuildTopScoresURL(Query);
+    ViewURL = URL;
+    PrefetchAwaitedURL.Reset();
+
+    // Only the most recent board is wanted, drop the one it supersedes before its response is parsed
+    if (bCancelSupersededTopScores)
     {
-        QueryParams.Add(FString::Printf(TEXT("starttime=%s"), *startTime));
+        Scheduler.Cancel(TopScoresHandle);
     }
-    if (!endTime.IsEmpty())
+    TopScoresHandle.Invalidate();
+
+    // Fetched or prefetched moments ago, shown without a request
+    if (const TLeaderboardResponseCache<FScores>::FEntry* Fresh = FindFreshBoard(URL))
     {
-        QueryParams.Add(FString::Printf(TEXT("endtime=%s"), *endTime));
+        OnTopScoresReceived.Broadcast(Fresh->Value);
+        SchedulePrefetch(Query);
+        return FLeaderboardRequestHandle();
     }
-    if (includeAllUsersScores)
+    // Already on its way as a prefetch, shown when that arrives
+    if (const FLeaderboardRequestHandle* Prefetch = PrefetchesInFlight.Find(URL))
     {
-        QueryParams.Add(FString("include_all_users_scores=true"));
+        PrefetchAwaitedURL = URL;
+        return *Prefetch;
     }
-    // Append limit of scores to get
-    QueryParams.Add(FString::Printf(TEXT("limit=%d"), NumTopScoresToGet));
-    
-    // Append query parameters to URL
-    if (!QueryParams.IsEmpty())
+
+    TopScoresHandle = GetTopScoresAsync(Query, [this](bool bSuccess, const FScores& Scores)
     {
-        url.Append("?");
-        url.Append(FString::Join(QueryParams, TEXT("&")));
-    }
-    
-    Request->SetURL(url);
-    Request->SetHeader("X-Mona-Application-Id", ApplicationID);
+        //Broadcast struct with info. No cyclical dependencies / hard references here :)
+        //This delegate can be bound to from any other C++ class or blueprint
+        if (bSuccess)
+        {
+            OnTopScoresReceived.Broadcast(Scores);
+        }
+    });
+    SchedulePrefetch(Query);
+    return TopScoresHandle;
+}
+
+FLeaderboardRequestHandle ULeaderboardController::GetTopScoresAsync(const FLeaderboardQuery& Query, FOnTopScoresComplete OnComplete, ELeaderboardRequestPriority Priority)
+{
+	if (!ValidAppID())
+	{
+		OnComplete(false, FScores());
+		return FLeaderboardRequestHandle();
+	}
+	TrackRolloverQuery(Query);
+	return SubmitTopScores(Query, MoveTemp(OnComplete), Priority, true);
+}
+
+FLeaderboardRequestHandle ULeaderboardController::SubmitTopScores(const FLeaderboardQuery& Query, FOnTopScoresComplete OnComplete, ELeaderboardRequestPriority Priority, bool bConditional)
+{
+	//Setup Request
+	FHttpRequestRef Request = RequestTemplates.Get(ELeaderboardEndpoint::TopScores).Instantiate();
+	//Format API call
+	const FString URL = BuildTopScoresURL(Query);
+	Request->SetURL(URL);
+	if (bConditional)
+	{
+		TopScoresCache.ApplyValidators(URL, Request);
+	}
+
+	//Bind Response Received Callback
+	return Scheduler.Submit(Request, ELeaderboardEndpoint::TopScores, Priority, FLeaderboardResponseDelegate::CreateUObject(this, &ULeaderboardController::TopScoresResponseReceived, Query, Priority, bConditional, MoveTemp(OnComplete)));
+}
+
+TFuture<TOptional<FScores>> ULeaderboardController::GetTopScoresAsync(const FLeaderboardQuery& Query)
+{
+	TSharedRef<TLeaderboardPromise<TOptional<FScores>>> Promise = MakeShared<TLeaderboardPromise<TOptional<FScores>>>();
+	TFuture<TOptional<FScores>> Future = Promise->GetFuture();
+	GetTopScoresAsync(Query, [Promise](bool bSuccess, const FScores& Scores)
+	{
+		Promise->SetValue(bSuccess ? TOptional<FScores>(Scores) : TOptional<FScores>());
+	});
+	return Future;
+}
+
+void ULeaderboardController::GetTopScoresMulti(const TArray<FLeaderboardQuery>& Queries, float TimeoutSeconds)
+{
+	GetTopScoresMultiAsync(Queries, [this](const FLeaderboardMultiResult& Result)
+	{
+		OnTopScoresMultiReceived.Broadcast(Result);
+	}, TimeoutSeconds);
+}
+
+void ULeaderboardController::GetTopScoresMultiAsync(const TArray<FLeaderboardQuery>& Queries, FOnTopScoresMultiComplete OnComplete, float TimeoutSeconds)
+{
+	TSharedRef<FLeaderboardMultiFetch> Fetch = MakeShared<FLeaderboardMultiFetch>();
+	Fetch->OnComplete = MoveTemp(OnComplete);
+	Fetch->Result.Boards.SetNum(Queries.Num());
+	for (int32 Index = 0; Index < Queries.Num(); ++Index)
+	{
+		Fetch->Result.Boards[Index].Query = Queries[Index];
+	}
+	Fetch->Handles.SetNum(Queries.Num());
+	Fetch->NumOutstanding = Queries.Num();
+	if (Queries.Num() == 0 || !ValidAppID())
+	{
+		FinishMultiFetch(Fetch);
+		return;
+	}
+	Fetch->DeadlineHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this, Fetch](float DeltaTime)
+	{
+		FinishMultiFetch(Fetch);
+		return false;
+	}), FMath::Max(TimeoutSeconds, 0.f));
+
+	if (!TopScoresBatchPath.IsEmpty())
+	{
+		//{"queries":["<query string>",...]}, the same query strings a single GET would use
+		TStringBuilder<2048> Body;
+		Body << TEXT("{\"queries\":[");
+		for (int32 Index = 0; Index < Queries.Num(); ++Index)
+		{
+			TStringBuilder<512> Query;
+			AppendTopScoresQuery(Query, Queries[Index]);
+			if (Index > 0) Body << TEXT(',');
+			Body << TEXT('"');
+			LeaderboardJson::AppendEscaped(Body, Query.ToView());
+			Body << TEXT('"');
+		}
+		Body << TEXT(']');
+		FHttpRequestRef Request = RequestTemplates.Get(ELeaderboardEndpoint::TopScoresBatch).Instantiate();
+		LeaderboardJson::SetContent(Request, Body);
+		//Bind Response Received Callback
+		Fetch->BatchHandle = Scheduler.Submit(Request, ELeaderboardEndpoint::TopScoresBatch, ELeaderboardRequestPriority::VisibleBoard, FLeaderboardResponseDelegate::CreateUObject(this, &ULeaderboardController::TopScoresBatchResponseReceived, Fetch));
+		return;
+	}
+	for (int32 Slot = 0; Slot < FMath::Max(1, MaxParallelMultiQueries); ++Slot)
+	{
+		LaunchNextMultiQuery(Fetch);
+	}
+}
+
+void ULeaderboardController::LaunchNextMultiQuery(const TSharedRef<FLeaderboardMultiFetch>& Fetch)
+{
+	if (Fetch->bDelivered || Fetch->NextIndex >= Fetch->Result.Boards.Num()) return;
+	const int32 Index = Fetch->NextIndex++;
+	//Goes through the regular top-scores pipeline: conditional GET cache, parsing and profile seeding
+	const FLeaderboardRequestHandle Handle = GetTopScoresAsync(Fetch->Result.Boards[Index].Query, [this, Fetch, Index](bool bSuccess, const FScores& Scores)
+	{
+		if (Fetch->bDelivered) return;
+		FLeaderboardMultiBoard& Board = Fetch->Result.Boards[Index];
+		Board.bSuccess = bSuccess;
+		Board.Scores = Scores;
+		if (--Fetch->NumOutstanding == 0)
+		{
+			FinishMultiFetch(Fetch);
+		}
+		else
+		{
+			LaunchNextMultiQuery(Fetch);
+		}
+	}, ELeaderboardRequestPriority::VisibleBoard);
+	//Harmless if it already completed synchronously, cancelling a finished request does nothing
+	Fetch->Handles[Index] = Handle;
+}
 
-    Request->ProcessRequest();
+void ULeaderboardController::FinishMultiFetch(const TSharedRef<FLeaderboardMultiFetch>& Fetch)
+{
+	if (Fetch->bDelivered) return;
+	Fetch->bDelivered = true;
+	FTSTicker::GetCoreTicker().RemoveTicker(Fetch->DeadlineHandle);
+	//Deadline passed, whatever is still pending is dropped rather than delivered late
+	Scheduler.Cancel(Fetch->BatchHandle);
+	for (const FLeaderboardRequestHandle& Handle : Fetch->Handles)
+	{
+		Scheduler.Cancel(Handle);
+	}
+	Fetch->Result.bComplete = Fetch->NumOutstanding == 0;
+	FOnTopScoresMultiComplete OnComplete = MoveTemp(Fetch->OnComplete);
+	if (OnComplete)
+	{
+		OnComplete(Fetch->Result);
+	}
+}
+
+void ULeaderboardController::TopScoresBatchResponseReceived(const FLeaderboardHttpResponse& Response, TSharedRef<FLeaderboardMultiFetch> Fetch)
+{
+	Fetch->BatchHandle.Invalidate();
+	if (Fetch->bDelivered) return;
+	const TArray<TSharedPtr<FJsonValue>>* Results = nullptr;
+	TSharedPtr<FJsonObject> ResponseObj;
+	if (ValidResponse(Response) && Response.Code != 304)
+	{
+		if (LeaderboardJson::Parse(Response.GetContentAsUtf8(), ResponseObj))
+		{
+			ResponseObj->TryGetArrayField(TEXT("results"), Results);
+		}
+	}
+	if (Results == nullptr)
+	{
+		//Batch endpoint missing or broken, the remaining time goes to fetching the boards one by one
+		UE_LOG(LogTemp, Warning, TEXT("Top scores batch failed, fetching %d boards individually"), Fetch->Result.Boards.Num());
+		for (int32 Slot = 0; Slot < FMath::Max(1, MaxParallelMultiQueries); ++Slot)
+		{
+			LaunchNextMultiQuery(Fetch);
+		}
+		return;
+	}
+	for (int32 Index = 0; Index < Fetch->Result.Boards.Num(); ++Index)
+	{
+		FLeaderboardMultiBoard& Board = Fetch->Result.Boards[Index];
+		const TSharedPtr<FJsonObject>* Object = nullptr;
+		if (Results->IsValidIndex(Index) && (*Results)[Index].IsValid() && (*Results)[Index]->TryGetObject(Object))
+		{
+			Board.bSuccess = ParseScores(Object->ToSharedRef(), Board.Scores);
+			if (Board.bSuccess)
+			{
+				StoreProfilesFromBoard(Board.Scores);
+				SeedPersonalBests(Board.Query, Board.Scores);
+			}
+		}
+	}
+	Fetch->NumOutstanding = 0;
+	FinishMultiFetch(Fetch);
 }
 
 void ULeaderboardController::ClientPostScore_Implementation(const float Score, const FString& Topic, const FString& InSDKSecret)
 {
-	if (!ValidAppID() || !ValidAuthorization()) return;
-	//Setup Request Body	
-	TSharedRef<FJsonObject> RequestObj = MakeShared<FJsonObject>();
-	int64 Timestamp = FDateTime::UtcNow().ToUnixTimestamp();
 	if (!InSDKSecret.IsEmpty() && SDKSecret.IsEmpty())
 	{
 		ServerSetSDKSecret(InSDKSecret);
 	}
-	if (SDKSecret.IsEmpty())
+	GetDefaultSession()->PostScore(Score, Topic);
+}
+
+void ULeaderboardController::SetApplicationID(const FString& InApplicationID)
+{
+	ApplicationID = InApplicationID;
+	PublishConfig();
+	RequestTemplates.Rebuild(BaseURL, ApplicationID, ProfilesPath, TopScoresBatchPath);
+}
+
+void ULeaderboardController::SetBaseURL(const FString& InBaseURL)
+{
+	BaseURL = InBaseURL;
+	RequestTemplates.Rebuild(BaseURL, ApplicationID, ProfilesPath, TopScoresBatchPath);
+}
+
+void ULeaderboardController::PostInitProperties()
+{
+	Super::PostInitProperties();
+	PublishConfig();
+	RequestTemplates.Rebuild(BaseURL, ApplicationID, ProfilesPath, TopScoresBatchPath);
+	ProfileCache.SetBudgetBytes(static_cast<int64>(ProfileCacheBudgetKB) * 1024);
+	//Batched lookups make a profile far cheaper to fetch again than a board
+	ProfileCache.SetRefetchCost(1.0 / FMath::Max(1, ProfileBatchSize));
+	MemoryBudget.SetBudgetBytes(static_cast<int64>(MemoryBudgetKB) * 1024);
+	MemoryBudget.Register(TopScoresCache);
+	MemoryBudget.Register(ProfileCache);
+	MemoryBudget.Register(Scheduler);
+}
+
+FString ULeaderboardController::BuildTopScoresURL(const FLeaderboardQuery& Query) const
+{
+	TStringBuilder<512> Builder;
+	Builder << RequestTemplates.GetTopScoresURLPrefix();
+	AppendTopScoresQuery(Builder, Query);
+	return FString(Builder.ToView());
+}
+
+void ULeaderboardController::AppendTopScoresQuery(FStringBuilderBase& Builder, const FLeaderboardQuery& Query, bool bPinWindow) const
+{
+	//The URL then changes exactly at rollover, so nothing cached for the old window can answer for the new one
+	if (bPinWindow && bDerivePeriodTimes && IsRollingQuery(Query))
 	{
-		UE_LOG(LogTemp, Error, TEXT("Error: LeaderboardController SDKSecret has not been set"));
+		TPair<FDateTime, FDateTime> Window;
+		GetCurrentPeriodWindow(Query.Period, Window.Key, Window.Value);
+		AppendTopScoresParams(Builder, Query, NumTopScoresToGet, &Window);
 		return;
 	}
-	const FString FormattedScore = FString::SanitizeFloat(Score, 3);
-	const FString Message = FormattedScore + ":" + FString::Printf(TEXT("%lld"), Timestamp) + ":" + Topic;
-	const FString Signature = GenerateHmac(Message, SDKSecret);
-	RequestObj->SetNumberField("score", Score);
-	RequestObj->SetStringField("timestamp", FString::Printf(TEXT("%lld"), Timestamp));
-	RequestObj->SetStringField("signature", Signature);
-	FString RequestBody;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBody);
-	FJsonSerializer::Serialize(RequestObj, Writer);
-	
+	AppendTopScoresParams(Builder, Query, NumTopScoresToGet);
+}
+
+void ULeaderboardController::AppendTopScoresParams(FStringBuilderBase& Builder, const FLeaderboardQuery& Query, int32 Limit, const TPair<FDateTime, FDateTime>* PinnedWindow)
+{
+	// Append optional parameters
+	if (Query.bFeatured)
+	{
+		Builder << TEXT("featured=true&");
+	}
+	if (!Query.Topic.IsEmpty())
+	{
+		Builder << TEXT("topic=") << Query.Topic << TEXT('&');
+	}
+	switch (Query.Period)
+	{
+		case ELeaderboardPeriod::daily:
+			Builder << TEXT("period=daily&");
+			break;
+		case ELeaderboardPeriod::weekly:
+			Builder << TEXT("period=weekly&");
+			break;
+		case ELeaderboardPeriod::monthly:
+			Builder << TEXT("period=monthly&");
+			break;
+		case ELeaderboardPeriod::all_time:
+			Builder << TEXT("period=all_time&");
+			break;
+	}
+	switch (Query.Order)
+	{
+		case ELeaderboardSortingOrder::highest:
+			Builder << TEXT("order=highest&");
+			break;
+		case ELeaderboardSortingOrder::lowest:
+			Builder << TEXT("order=lowest&");
+			break;
+	}
+	if (!Query.StartTime.IsEmpty())
+	{
+		Builder << TEXT("starttime=") << Query.StartTime << TEXT('&');
+	}
+	if (!Query.EndTime.IsEmpty())
+	{
+		Builder << TEXT("endtime=") << Query.EndTime << TEXT('&');
+	}
+	if (PinnedWindow)
+	{
+		Builder << TEXT("starttime=") << PinnedWindow->Key.ToIso8601() << TEXT("&endtime=") << PinnedWindow->Value.ToIso8601() << TEXT('&');
+	}
+	if (Query.bIncludeAllUsersScores)
+	{
+		Builder << TEXT("include_all_users_scores=true&");
+	}
+	// Append limit of scores to get
+	Builder << TEXT("limit=") << Limit;
+}
+
+void ULeaderboardController::StartLiveLeaderboard(const FLeaderboardQuery& Query, float MinPollInterval, float MaxPollInterval)
+{
+	if (!ValidAppID()) return;
+	StopLiveLeaderboard();
+	bLiveActive = true;
+	LiveQuery = Query;
+	TrackRolloverQuery(Query);
+	LiveMinPollInterval = FMath::Max(0.1f, MinPollInterval);
+	LiveMaxPollInterval = FMath::Max(LiveMinPollInterval, MaxPollInterval);
+	LivePollInterval = LiveMinPollInterval;
+	//First poll seeds the board, the stream (if any) only carries updates after that
+	LiveNextPollTime = 0.0;
+	//A replay has no recorded stream to play back, it polls instead
+	if (!LiveLeaderboardStreamURL.IsEmpty() && !IsReplaying())
+	{
+		ConnectLiveStream();
+	}
+	LiveTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULeaderboardController::TickLiveLeaderboard), 0.1f);
+}
+
+void ULeaderboardController::StopLiveLeaderboard()
+{
+	if (!bLiveActive) return;
+	bLiveActive = false;
+	FTSTicker::GetCoreTicker().RemoveTicker(LiveTickerHandle);
+	LiveTickerHandle.Reset();
+	Scheduler.Cancel(LivePollHandle);
+	LivePollHandle.Invalidate();
+	if (LiveSocket.IsValid())
+	{
+		LiveSocket->OnMessage().RemoveAll(this);
+		LiveSocket->OnConnectionError().RemoveAll(this);
+		LiveSocket->OnClosed().RemoveAll(this);
+		LiveSocket->Close();
+		LiveSocket.Reset();
+	}
+	bLiveStreamFailed = false;
+	bHasLiveBoard = false;
+	LiveBoard = FScores();
+}
+
+bool ULeaderboardController::TickLiveLeaderboard(float DeltaTime)
+{
+	if (!bLiveActive) return false;
+	//Drop a broken stream outside of its own callbacks and keep going by polling
+	if (bLiveStreamFailed && LiveSocket.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Live leaderboard stream lost - falling back to polling"));
+		LiveSocket->OnMessage().RemoveAll(this);
+		LiveSocket->OnConnectionError().RemoveAll(this);
+		LiveSocket->OnClosed().RemoveAll(this);
+		LiveSocket.Reset();
+		LivePollInterval = LiveMinPollInterval;
+		LiveNextPollTime = 0.0;
+	}
+	//Until the stream is connected it carries nothing, a connect attempt may hang without ever reporting an error
+	const bool bStreaming = LiveSocket.IsValid() && LiveSocket->IsConnected() && bHasLiveBoard;
+	if (!bStreaming && !LivePollHandle.IsValid() && FPlatformTime::Seconds() >= LiveNextPollTime)
+	{
+		PollLiveLeaderboard();
+	}
+	return true;
+}
+
+void ULeaderboardController::PollLiveLeaderboard()
+{
 	//Setup Request
-	FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
-	Request->SetVerb("POST");
+	FHttpRequestRef Request = RequestTemplates.Get(ELeaderboardEndpoint::TopScores).Instantiate();
+	const FString URL = BuildTopScoresURL(LiveQuery);
+	Request->SetURL(URL);
+	//Server answers 304 with no body when the board has not changed
+	TopScoresCache.ApplyValidators(URL, Request);
 	//Bind Response Received Callback
-	Request->OnProcessRequestComplete().BindUObject(this, &ULeaderboardController::ClientPostScoreResponseReceived);
-	//Format API call
-	Request->SetURL(TEXT("https://api.monaverse.com/public/leaderboards/sdk/score"));
-	//Set Header Info
-	Request->SetHeader("accept", "application/json");
-	Request->AppendToHeader("X-Mona-Application-Id", ApplicationID);
-	Request->AppendToHeader("content-type", "application/json");
-	Request->AppendToHeader("Authorization", "Bearer " + AccessToken);
-	//Set Request Body
-	Request->SetContentAsString(RequestBody);
+	LivePollHandle = Scheduler.Submit(Request, ELeaderboardEndpoint::TopScores, ELeaderboardRequestPriority::VisibleBoard, FLeaderboardResponseDelegate::CreateUObject(this, &ULeaderboardController::LivePollResponseReceived));
+}
 
-	Request->ProcessRequest();
+void ULeaderboardController::LivePollResponseReceived(const FLeaderboardHttpResponse& Response)
+{
+	LivePollHandle.Invalidate();
+	if (!bLiveActive) return;
+	bool bChanged = false;
+	bool bPollSoon = false;
+	if (Response.Code == 304)
+	{
+		//Not modified since the cached board, which may not have reached the live board yet (e.g. a GetTopScores
+		//of the same query just before StartLiveLeaderboard)
+		if (const TLeaderboardResponseCache<FScores>::FEntry* Cached = TopScoresCache.Find(Response.URL))
+		{
+			TopScoresCache.MarkRevalidated(Response.URL);
+			const FScores Board = Cached->Value;
+			bChanged = ApplyLiveBoard(Board);
+		}
+		else
+		{
+			//Evicted while in flight, the next poll goes out without validators
+			TopScoresCache.Remove(Response.URL);
+			bPollSoon = true;
+		}
+	}
+	else if (ValidResponse(Response))
+	{
+		FScores Board;
+		if (ParseScores(Response.GetContentAsUtf8(), Board))
+		{
+			TopScoresCache.Store(Response.URL, FLeaderboardValidators::FromResponse(Response), Board, GetRolloverTimeToLive(LiveQuery));
+			StoreProfilesFromBoard(Board);
+			bChanged = ApplyLiveBoard(Board);
+		}
+	}
+	//Poll quickly while the board moves, back off while it is quiet or failing
+	LivePollInterval = bChanged || bPollSoon ? LiveMinPollInterval : FMath::Min(LivePollInterval * 2.f, LiveMaxPollInterval);
+	LiveNextPollTime = FPlatformTime::Seconds() + LivePollInterval;
 }
 
-bool ULeaderboardController::ValidAppID() const
+void ULeaderboardController::ConnectLiveStream()
 {
-	if (ApplicationID.IsEmpty())
+	TMap<FString, FString> UpgradeHeaders;
+	UpgradeHeaders.Add(TEXT("X-Mona-Application-Id"), ApplicationID);
+	TStringBuilder<512> URL;
+	URL << LiveLeaderboardStreamURL << TEXT('?');
+	//A stream outlives the window, it has to follow the period itself
+	AppendTopScoresQuery(URL, LiveQuery, false);
+	LiveSocket = FModuleManager::LoadModuleChecked<FWebSocketsModule>(TEXT("WebSockets")).CreateWebSocket(FString(URL.ToView()), TEXT(""), UpgradeHeaders);
+	LiveSocket->OnMessage().AddUObject(this, &ULeaderboardController::LiveStreamMessageReceived);
+	LiveSocket->OnConnectionError().AddWeakLambda(this, [this](const FString& Error)
 	{
-		//Debug messages
-		if (bShowDebug)
+		UE_LOG(LogTemp, Warning, TEXT("Live leaderboard stream error: %s"), *Error);
+		LiveStreamFailed();
+	});
+	LiveSocket->OnClosed().AddWeakLambda(this, [this](int32 StatusCode, const FString& Reason, bool bWasClean)
+	{
+		LiveStreamFailed();
+	});
+	LiveSocket->Connect();
+}
+
+void ULeaderboardController::LiveStreamMessageReceived(const FString& Message)
+{
+	if (!bLiveActive) return;
+	//Every pushed message is a full top-scores payload
+	FScores Board;
+	if (ParseScores(Message, Board))
+	{
+		ApplyLiveBoard(Board);
+	}
+}
+
+void ULeaderboardController::LiveStreamFailed()
+{
+	bLiveStreamFailed = true;
+}
+
+bool ULeaderboardController::ApplyLiveBoard(const FScores& Board)
+{
+	SeedPersonalBests(LiveQuery, Board);
+	TMap<int, const FUserInfo*> PreviousRows;
+	PreviousRows.Reserve(LiveBoard.Items.Num());
+	for (const FUserInfo& Row : LiveBoard.Items)
+	{
+		PreviousRows.Add(Row.ID, &Row);
+	}
+	TArray<FUserInfo> ChangedRows;
+	for (const FUserInfo& Row : Board.Items)
+	{
+		const FUserInfo* const* Previous = PreviousRows.Find(Row.ID);
+		if (Previous == nullptr || (*Previous)->Score != Row.Score || (*Previous)->Rank != Row.Rank)
 		{
-			UE_LOG(LogTemp, Error, TEXT("Error: LeaderboardController ApplicationID has not been set"));
-			if (GEngine)
-			{
-				GEngine->AddOnScreenDebugMessage(
-				   22,
-				   3.f,
-				   FColor::Red,
-				   TEXT("Error: LeaderboardController ApplicationID has not been set"));
-			}
+			ChangedRows.Add(Row);
 		}
-		return false;
 	}
+	const bool bChanged = !bHasLiveBoard || ChangedRows.Num() > 0 || Board.Items.Num() != LiveBoard.Items.Num() || Board.Count != LiveBoard.Count;
+	if (!bChanged) return false;
+
+	LiveBoard = Board;
+	bHasLiveBoard = true;
+	OnTopScoresReceived.Broadcast(LiveBoard);
+	OnLiveLeaderboardChanged.Broadcast(LiveBoard, ChangedRows);
 	return true;
 }
 
-bool ULeaderboardController::ValidResponse(const FHttpResponsePtr& Response)
+FDateTime ULeaderboardController::GetPeriodStart(ELeaderboardPeriod Period, const FDateTime& Time)
 {
-	if (Response->GetResponseCode() == 401)
+	const FDateTime Day = Time.GetDate();
+	switch (Period)
 	{
-		RefreshAccessToken();
+		case ELeaderboardPeriod::daily:
+			return Day;
+		case ELeaderboardPeriod::weekly:
+			//EDayOfWeek counts from Monday
+			return Day - FTimespan::FromDays(static_cast<int32>(Day.GetDayOfWeek()));
+		case ELeaderboardPeriod::monthly:
+			return FDateTime(Day.GetYear(), Day.GetMonth(), 1);
+		case ELeaderboardPeriod::all_time:
+		default:
+			return FDateTime::MinValue();
 	}
-	//200 is valid response code here
-	if (Response->GetResponseCode() != 200)
+}
+
+FDateTime ULeaderboardController::GetPeriodEnd(ELeaderboardPeriod Period, const FDateTime& Time)
+{
+	const FDateTime Start = GetPeriodStart(Period, Time);
+	switch (Period)
 	{
-		//Debug messages
-		if (GEngine && bShowDebug)
-			GEngine->AddOnScreenDebugMessage(22, 3.f, FColor::Red, FString::Printf(TEXT("Error: Invalid Response Code: %d"), Response->GetResponseCode()));
+		case ELeaderboardPeriod::daily:
+			return Start + FTimespan::FromDays(1);
+		case ELeaderboardPeriod::weekly:
+			return Start + FTimespan::FromDays(7);
+		case ELeaderboardPeriod::monthly:
+			return Start.GetMonth() == 12 ? FDateTime(Start.GetYear() + 1, 1, 1) : FDateTime(Start.GetYear(), Start.GetMonth() + 1, 1);
+		case ELeaderboardPeriod::all_time:
+		default:
+			return FDateTime::MaxValue();
+	}
+}
+
+void ULeaderboardController::GetCurrentPeriodWindow(ELeaderboardPeriod Period, FDateTime& OutStart, FDateTime& OutEnd)
+{
+	const FDateTime Now = FDateTime::UtcNow();
+	OutStart = GetPeriodStart(Period, Now);
+	OutEnd = GetPeriodEnd(Period, Now);
+}
+
+bool ULeaderboardController::IsRollingQuery(const FLeaderboardQuery& Query)
+{
+	//An explicit window never rolls over
+	return Query.Period != ELeaderboardPeriod::all_time && Query.StartTime.IsEmpty() && Query.EndTime.IsEmpty();
+}
+
+double ULeaderboardController::GetRolloverTimeToLive(const FLeaderboardQuery& Query)
+{
+	if (!IsRollingQuery(Query)) return 0.0;
+	const FDateTime Now = FDateTime::UtcNow();
+	//Never 0, which would mean no expiry
+	return FMath::Max((GetPeriodEnd(Query.Period, Now) - Now).GetTotalSeconds(), 0.001);
+}
+
+void ULeaderboardController::TrackRolloverQuery(const FLeaderboardQuery& Query)
+{
+	if (!IsRollingQuery(Query) || RolloverPrefetchDelay < 0.f) return;
+	const bool bTracked = RolloverQueries.ContainsByPredicate([&Query](const FLeaderboardQuery& Tracked)
+	{
+		return Tracked.Period == Query.Period && Tracked.Topic == Query.Topic && Tracked.Order == Query.Order
+			&& Tracked.bFeatured == Query.bFeatured && Tracked.bIncludeAllUsersScores == Query.bIncludeAllUsersScores;
+	});
+	if (bTracked) return;
+	//Only what was on screen lately is worth prefetching
+	constexpr int32 MaxRolloverQueries = 16;
+	if (RolloverQueries.Num() >= MaxRolloverQueries)
+	{
+		RolloverQueries.RemoveAt(0);
+	}
+	RolloverQueries.Add(Query);
+	ScheduleRollover();
+}
+
+void ULeaderboardController::ScheduleRollover()
+{
+	const FDateTime Now = FDateTime::UtcNow();
+	FDateTime Next = FDateTime::MaxValue();
+	for (const FLeaderboardQuery& Query : RolloverQueries)
+	{
+		Next = FMath::Min(Next, GetPeriodEnd(Query.Period, Now));
+	}
+	if (RolloverHandle.IsValid() && Next == NextRollover) return;
+	FTSTicker::GetCoreTicker().RemoveTicker(RolloverHandle);
+	RolloverHandle.Reset();
+	NextRollover = Next;
+	if (Next == FDateTime::MaxValue()) return;
+	const float Delay = static_cast<float>((Next - Now).GetTotalSeconds()) + FMath::Max(RolloverPrefetchDelay, 0.f);
+	RolloverHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULeaderboardController::HandleRollover), Delay);
+}
+
+bool ULeaderboardController::HandleRollover(float DeltaTime)
+{
+	RolloverHandle.Reset();
+	const FDateTime Rollover = NextRollover;
+	const FDateTime Now = FDateTime::UtcNow();
+	//Ticker time and the wall clock drift apart over delays of days or weeks
+	if (Now < Rollover)
+	{
+		ScheduleRollover();
 		return false;
 	}
+	TArray<ELeaderboardPeriod, TInlineAllocator<3>> RolledOver;
+	for (const FLeaderboardQuery& Query : RolloverQueries)
+	{
+		if (GetPeriodStart(Query.Period, Now) >= Rollover && !RolledOver.Contains(Query.Period))
+		{
+			RolledOver.Add(Query.Period);
+		}
+	}
+	//Boards of the new window, so the refetches the broadcast below causes are answered from cache
+	const TArray<FLeaderboardQuery> Queries = RolloverQueries;
+	for (const FLeaderboardQuery& Query : Queries)
+	{
+		if (RolledOver.Contains(Query.Period) && !(bLiveActive && Query.Period == LiveQuery.Period && Query.Topic == LiveQuery.Topic))
+		{
+			GetTopScoresAsync(Query, [](bool bSuccess, const FScores& Scores) {}, ELeaderboardRequestPriority::Prefetch);
+		}
+	}
+	//A live board polls its new window right away instead of waiting out its backoff, even while streaming
+	if (bLiveActive && RolledOver.Contains(LiveQuery.Period))
+	{
+		LivePollInterval = LiveMinPollInterval;
+		LiveNextPollTime = 0.0;
+		bHasLiveBoard = false;
+	}
+	for (const ELeaderboardPeriod Period : RolledOver)
+	{
+		OnPeriodRolledOver.Broadcast(Period);
+	}
+	ScheduleRollover();
+	return false;
+}
+
+bool ULeaderboardController::CancelRequest(FLeaderboardRequestHandle Handle)
+{
+	if (Handle == TopScoresHandle)
+	{
+		TopScoresHandle.Invalidate();
+	}
+	//A view waiting on a prefetch was handed the prefetch's handle
+	for (TMap<FString, FLeaderboardRequestHandle>::TIterator It = PrefetchesInFlight.CreateIterator(); It; ++It)
+	{
+		if (It.Value() == Handle)
+		{
+			if (It.Key() == PrefetchAwaitedURL)
+			{
+				PrefetchAwaitedURL.Reset();
+			}
+			It.RemoveCurrent();
+		}
+	}
+	return Scheduler.Cancel(Handle);
+}
+
+FString ULeaderboardController::GetViewKey(const FLeaderboardQuery& Query)
+{
+	//Everything that tells one tab from another. Derived window times are not part of the query, so a view outlives rollovers
+	return FString::Printf(TEXT("%d|%d|%d|%d|%s|%s|%s"), static_cast<int32>(Query.Period), static_cast<int32>(Query.Order),
+		Query.bFeatured ? 1 : 0, Query.bIncludeAllUsersScores ? 1 : 0, *Query.StartTime, *Query.EndTime, *Query.Topic);
+}
+
+const TLeaderboardResponseCache<FScores>::FEntry* ULeaderboardController::FindFreshBoard(const FString& URL) const
+{
+	if (FreshBoardMaxAge <= 0.f) return nullptr;
+	const TLeaderboardResponseCache<FScores>::FEntry* Entry = TopScoresCache.Find(URL);
+	return Entry && FPlatformTime::Seconds() - Entry->StoredTime <= FreshBoardMaxAge ? Entry : nullptr;
+}
+
+void ULeaderboardController::InvalidateTopic(const FString& Topic)
+{
+	//Boards of the default topic carry no topic parameter at all
+	const FString First = FString::Printf(TEXT("?topic=%s&"), *Topic);
+	const FString Later = FString::Printf(TEXT("&topic=%s&"), *Topic);
+	TopScoresCache.RemoveIf([&Topic, &First, &Later](const FString& URL)
+	{
+		return Topic.IsEmpty() ? !URL.Contains(TEXT("?topic=")) && !URL.Contains(TEXT("&topic=")) : URL.Contains(First) || URL.Contains(Later);
+	});
+}
+
+void ULeaderboardController::SchedulePrefetch(const FLeaderboardQuery& From)
+{
+	//A prefetched board is only ever shown through FindFreshBoard, without it prefetching just spends requests
+	if (FreshBoardMaxAge <= 0.f) return;
+	NavigationModel.Predict(GetViewKey(From), PrefetchViewCount, PrefetchMinProbability, PrefetchCandidates);
+	if (PrefetchCandidates.Num() == 0 || PrefetchHandle.IsValid() || ApplicationID.IsEmpty()) return;
+	PrefetchHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULeaderboardController::TickPrefetch), 0.25f);
+}
+
+bool ULeaderboardController::TickPrefetch(float DeltaTime)
+{
+	//Prefetches only ever use an idle network, they never delay what the player asked for
+	if (Scheduler.GetNumInFlight() > 0 || Scheduler.GetNumQueued() > 0) return true;
+	//A completion below may broadcast, and a listener may navigate again
+	const TArray<FLeaderboardQuery> Candidates = MoveTemp(PrefetchCandidates);
+	PrefetchCandidates.Reset();
+	PrefetchHandle.Reset();
+
+	const double Now = FPlatformTime::Seconds();
+	PrefetchTimes.RemoveAll([Now](double Time) { return Now - Time >= 60.0; });
+	for (const FLeaderboardQuery& Query : Candidates)
+	{
+		if (PrefetchTimes.Num() >= PrefetchBudgetPerMinute) break;
+		const FString URL = BuildTopScoresURL(Query);
+		if (URL == ViewURL || PrefetchesInFlight.Contains(URL) || FindFreshBoard(URL)) continue;
+		PrefetchTimes.Add(Now);
+		//Added first, a request that completes right away removes it again
+		PrefetchesInFlight.Add(URL);
+		const FLeaderboardRequestHandle Handle = GetTopScoresAsync(Query, [this, URL](bool bSuccess, const FScores& Scores)
+		{
+			PrefetchesInFlight.Remove(URL);
+			//The player opened this view before the prefetch arrived
+			if (URL == PrefetchAwaitedURL)
+			{
+				PrefetchAwaitedURL.Reset();
+				if (bSuccess)
+				{
+					OnTopScoresReceived.Broadcast(Scores);
+				}
+			}
+		}, ELeaderboardRequestPriority::Prefetch);
+		if (FLeaderboardRequestHandle* Pending = PrefetchesInFlight.Find(URL))
+		{
+			*Pending = Handle;
+		}
+	}
+	return false;
+}
+
+void ULeaderboardController::ResolveProfiles(const TArray<FString>& Usernames)
+{
+	for (const FString& Username : Usernames)
+	{
+		if (Username.IsEmpty()) continue;
+		if (const FLeaderboardProfile* Profile = ProfileCache.Find(Username))
+		{
+			OnProfileResolved.Broadcast(*Profile);
+			continue;
+		}
+		//No lookup endpoint, profiles only come from boards
+		if (ProfilesPath.IsEmpty()) continue;
+		bool bAlreadyPending = false;
+		ProfilesPending.Add(Username, &bAlreadyPending);
+		if (!bAlreadyPending)
+		{
+			ProfileQueue.Add(Username);
+		}
+	}
+	//Every row that asks during this frame goes out in the same batch
+	if (ProfileQueue.Num() > 0 && !ProfileFlushHandle.IsValid())
+	{
+		ProfileFlushHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULeaderboardController::FlushProfileQueue));
+	}
+}
+
+bool ULeaderboardController::FindProfile(const FString& Username, FLeaderboardProfile& OutProfile)
+{
+	const FLeaderboardProfile* Profile = ProfileCache.Find(Username);
+	if (Profile == nullptr) return false;
+	OutProfile = *Profile;
 	return true;
 }
 
-bool ULeaderboardController::ValidAuthorization() const
+bool ULeaderboardController::FlushProfileQueue(float DeltaTime)
 {
-	if (AccessToken.IsEmpty() || RefreshToken.IsEmpty())
+	ProfileFlushHandle.Reset();
+	if (!ValidAppID())
 	{
-		if (GEngine && bShowDebug)
-			GEngine->AddOnScreenDebugMessage(22, 3.f, FColor::Red, TEXT("Error: AccessToken / RefreshToken has not been validated"));
+		for (const FString& Username : ProfileQueue)
+		{
+			ProfilesPending.Remove(Username);
+		}
+		ProfileQueue.Reset();
 		return false;
 	}
-	return true;
+	const int32 BatchSize = FMath::Max(1, ProfileBatchSize);
+	for (int32 Start = 0; Start < ProfileQueue.Num(); Start += BatchSize)
+	{
+		TArray<FString> Batch(ProfileQueue.GetData() + Start, FMath::Min(BatchSize, ProfileQueue.Num() - Start));
+		TStringBuilder<2048> URL;
+		URL << RequestTemplates.Get(ELeaderboardEndpoint::Profiles).URL;
+		for (int32 Index = 0; Index < Batch.Num(); ++Index)
+		{
+			if (Index > 0) URL << TEXT(',');
+			URL << FGenericPlatformHttp::UrlEncode(Batch[Index]);
+		}
+		FHttpRequestRef Request = RequestTemplates.Get(ELeaderboardEndpoint::Profiles).Instantiate();
+		Request->SetURL(FString(URL.ToView()));
+		//Bind Response Received Callback
+		Scheduler.Submit(Request, ELeaderboardEndpoint::Profiles, ELeaderboardRequestPriority::VisibleBoard, FLeaderboardResponseDelegate::CreateUObject(this, &ULeaderboardController::ProfilesResponseReceived, MoveTemp(Batch)));
+	}
+	ProfileQueue.Reset();
+	return false;
 }
 
-FString ULeaderboardController::GenerateHmac(const FString& Message, const FString& Key)
+void ULeaderboardController::ProfilesResponseReceived(const FLeaderboardHttpResponse& Response, TArray<FString> Requested)
 {
-	// Convert FString to std::string for OpenSSL compatibility
-	std::string MessageStr = TCHAR_TO_UTF8(*Message);
-	std::string KeyStr = TCHAR_TO_UTF8(*Key);
+	//Whatever happens these may be asked for again
+	for (const FString& Username : Requested)
+	{
+		ProfilesPending.Remove(Username);
+	}
+	if (!ValidResponse(Response)) return;
+	//Either a bare array of profiles or an object with an "items" array, like top scores
+	TSharedPtr<FJsonValue> Root;
+	if (!LeaderboardJson::Parse(Response.GetContentAsUtf8(), Root)) return;
+	const TArray<TSharedPtr<FJsonValue>>* Items = nullptr;
+	if (Root->Type == EJson::Array)
+	{
+		Items = &Root->AsArray();
+	}
+	else if (Root->Type == EJson::Object)
+	{
+		Root->AsObject()->TryGetArrayField(TEXT("items"), Items);
+	}
+	if (Items == nullptr) return;
+	for (const TSharedPtr<FJsonValue>& Item : *Items)
+	{
+		const TSharedPtr<FJsonObject>* Object = nullptr;
+		FLeaderboardProfile Profile;
+		if (!Item.IsValid() || !Item->TryGetObject(Object)) continue;
+		if (!FJsonObjectConverter::JsonObjectToUStruct<FLeaderboardProfile>(Object->ToSharedRef(), &Profile) || Profile.Username.IsEmpty()) continue;
+		ProfileCache.Store(Profile);
+		OnProfileResolved.Broadcast(Profile);
+	}
+}
 
-	// Compute HMAC SHA-256
-	unsigned char* Hash = HMAC(EVP_sha256(),
-							   reinterpret_cast<const unsigned char*>(KeyStr.c_str()),
-							   KeyStr.length(),
-							   reinterpret_cast<const unsigned char*>(MessageStr.c_str()),
-							   MessageStr.length(),
-							   nullptr,
-							   nullptr);
+void ULeaderboardController::SeedPersonalBests(const FLeaderboardQuery& Query, const FScores& Board)
+{
+	const FDateTime Now = FDateTime::UtcNow();
+	auto Seed = [&](ULeaderboardSession* Session)
+	{
+		//The username is only known once GetUser has answered
+		if (Session && !Session->CurrentUser.Username.IsEmpty())
+		{
+			Session->GetPersonalBests().SeedFromBoard(Query, Board, Session->CurrentUser.Username, Now);
+		}
+	};
+	Seed(DefaultSession);
+	for (const TPair<FString, TObjectPtr<ULeaderboardSession>>& Pair : Sessions)
+	{
+		Seed(Pair.Value);
+	}
+}
 
-	// Base64 encode the hash
-	TArray<uint8> HashArray(Hash, SHA256_DIGEST_LENGTH);
-	FString Base64Hash = FBase64::Encode(HashArray);
+void ULeaderboardController::StoreProfilesFromBoard(const FScores& Board)
+{
+	//With a lookup endpoint the board's names are incomplete profiles, let ResolveProfiles fetch the full ones
+	if (!ProfilesPath.IsEmpty()) return;
+	for (const FUserInfo& Info : Board.Items)
+	{
+		if (ProfileCache.Contains(Info.User.Username)) continue;
+		FLeaderboardProfile Profile;
+		Profile.Username = Info.User.Username;
+		Profile.Name = Info.User.Name;
+		ProfileCache.Store(Profile);
+	}
+}
 
-	return Base64Hash;
+void ULeaderboardController::PublishConfig()
+{
+	FLeaderboardConfig NewConfig;
+	NewConfig.ApplicationID = ApplicationID;
+	NewConfig.SDKSecret = SDKSecret;
+	Config.Store(MoveTemp(NewConfig));
 }
 
-void ULeaderboardController::FinishDestroy()
+bool ULeaderboardController::ExportScores(const FScores& Scores, const FString& Path)
 {
-	UObject::FinishDestroy();
-	//Delete singleton
-	Instance = nullptr;
+	FLeaderboardColumnarWriter Writer;
+	if (!Writer.Open(Path)) return false;
+	Writer.Add(Scores);
+	return Writer.Close();
 }
 
-void ULeaderboardController::GetUser(const FString& BearerToken)
+bool ULeaderboardController::ImportScores(const FString& Path, FScores& OutScores)
 {
-	if (!ValidAppID()) return;
-	if (AccessToken.IsEmpty())
+	return FLeaderboardColumnarReader::LoadFile(Path, OutScores);
+}
+
+void ULeaderboardController::SetDiagnosticsVisible(bool bVisible)
+{
+#if WITH_LEADERBOARD_DIAGNOSTICS
+	FLeaderboardDiagnostics::SetVisible(bVisible);
+#endif
+}
+
+bool ULeaderboardController::ExportCachedScores(const FString& Path)
+{
+	FLeaderboardColumnarWriter Writer;
+	if (!Writer.Open(Path)) return false;
+	//Keyed by request URL, which carries the board's period, order, featured flag and window
+	TopScoresCache.ForEach([&Writer](const FString& URL, const TLeaderboardResponseCache<FScores>::FEntry& Entry)
 	{
-		UE_LOG(LogTemp, Error, TEXT("Error: Leaderboard Controller Access Token has not been set"));
-		return;
+		Writer.BeginBoard(URL);
+		Writer.Add(Entry.Value);
+	});
+	const bool bSuccess = Writer.Close();
+	UE_LOG(LogTemp, Display, TEXT("Leaderboard export: %lld rows from %d boards to %s%s"), Writer.GetNumRows(), TopScoresCache.Num(), *Path, bSuccess ? TEXT("") : TEXT(" FAILED"));
+	return bSuccess;
+}
+
+void ULeaderboardController::StartRecording()
+{
+	if (RecordingTransport.IsValid()) return;
+	RecordingTransport = MakeShared<FLeaderboardRecordingTransport>(Scheduler.GetTransport());
+	Scheduler.SetTransport(RecordingTransport.ToSharedRef());
+}
+
+bool ULeaderboardController::StopRecording(const FString& Path)
+{
+	if (!RecordingTransport.IsValid()) return false;
+	//Only unwrap if a replay has not replaced the recorder since
+	if (Scheduler.GetTransport() == RecordingTransport.ToSharedRef())
+	{
+		Scheduler.SetTransport(RecordingTransport->GetInner());
 	}
-	//Setup Request
-	FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
-	Request->SetVerb("GET");
-	//Bind Response Received Callback
-	Request->OnProcessRequestComplete().BindUObject(this, &ULeaderboardController::GetUserResponseReceived);
-	//Format API call
-	FString url = "https://api.monaverse.com/public/user/";
-	//Set limit of scores to get
-	Request->SetURL(url);
-	Request->SetHeader("X-Mona-Application-Id", ApplicationID);
-	Request->AppendToHeader("Authorization", FString::Printf(TEXT("Bearer %s"), *AccessToken));
+	const bool bSaved = RecordingTransport->GetRecording().SaveToFile(Path);
+	UE_LOG(LogTemp, Display, TEXT("Leaderboard recording: %d exchange(s) %s %s"), RecordingTransport->GetRecording().Exchanges.Num(), bSaved ? TEXT("written to") : TEXT("could not be written to"), *Path);
+	RecordingTransport.Reset();
+	return bSaved;
+}
 
-	Request->ProcessRequest();
+bool ULeaderboardController::StartReplay(const FString& Path, float Speed)
+{
+	FLeaderboardRecording Recording;
+	if (!Recording.LoadFromFile(Path)) return false;
+	ReplayTransport = MakeShared<FLeaderboardReplayTransport>(Recording, Speed);
+	Scheduler.SetTransport(ReplayTransport.ToSharedRef());
+	UE_LOG(LogTemp, Display, TEXT("Leaderboard replay: %d exchange(s) from %s at %.2fx"), Recording.Exchanges.Num(), *Path, Speed);
+	return true;
 }
 
-void ULeaderboardController::TopScoresResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response,
-                                                       bool bConnectedSuccessfully)
+void ULeaderboardController::StopReplay()
 {
-	if (!ValidResponse(Response)) return;
-	//Read response content as JSON
-	TSharedPtr<FJsonObject> ResponseObj;
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-	FJsonSerializer::Deserialize(Reader, ResponseObj);
+	if (!ReplayTransport.IsValid()) return;
+	ReplayTransport.Reset();
+	Scheduler.SetTransport(MakeShared<FLeaderboardHttpTransport>());
+}
 
-	//Convert JSON object into custom struct to hold info
-	FScores AllScores;
-	if (FJsonObjectConverter::JsonObjectToUStruct<FScores>(ResponseObj.ToSharedRef(), &AllScores))
+void ULeaderboardController::ApplyCommandLine()
+{
+	//Dedicated servers get the signing secret from their launch environment, it never ships in a client build
+	FString Secret;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("MonaSDKSecret="), Secret))
 	{
-		//Broadcast struct with info. No cyclical dependencies / hard references here :)
-		//This delegate can be bound to from any other C++ class or blueprint
-		OnTopScoresReceived.Broadcast(AllScores);
-	} else
+		Secret = FPlatformMisc::GetEnvironmentVariable(TEXT("MONA_SDK_SECRET"));
+	}
+	if (!Secret.IsEmpty())
 	{
-		UE_LOG(LogTemp, Display, TEXT("Object Conversion Failed"));
+		SDKSecret = Secret;
+		PublishConfig();
+	}
+	FString ReplayPath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("MonaReplay="), ReplayPath))
+	{
+		float Speed = 1.f;
+		FParse::Value(FCommandLine::Get(), TEXT("MonaReplaySpeed="), Speed);
+		StartReplay(ReplayPath, Speed);
+	}
+	if (FParse::Value(FCommandLine::Get(), TEXT("MonaRecord="), CommandLineRecordingPath))
+	{
+		StartRecording();
 	}
 }
 
-void ULeaderboardController::ClientPostScoreResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response,
-	bool bConnectedSuccessfully)
+void ULeaderboardController::SetMaxConcurrentRequests(int32 InMaxConcurrentRequests)
+{
+	Scheduler.SetMaxConcurrentRequests(InMaxConcurrentRequests);
+}
+
+bool ULeaderboardController::ValidAppID() const
 {
-	if (bConnectedSuccessfully && Response.IsValid())
+	if (ApplicationID.IsEmpty())
 	{
-		if (Response->GetResponseCode() == 200)
+		//Debug messages
+		if (bShowDebug)
 		{
-			OnScorePosted.Broadcast();
+			UE_LOG(LogTemp, Error, TEXT("Error: LeaderboardController ApplicationID has not been set"));
+#if WITH_LEADERBOARD_DIAGNOSTICS
+			if (FLeaderboardDiagnostics::IsVisible())
+			{
+				FLeaderboardDiagnostics::AddMessage(TEXT("Error: LeaderboardController ApplicationID has not been set"));
+			}
+#endif
 		}
-		if (Response->GetResponseCode() == 401)
+		return false;
+	}
+	return true;
+}
+
+bool ULeaderboardController::ValidResponse(const FLeaderboardHttpResponse& Response, ULeaderboardSession* Session)
+{
+	//No response at all when the connection failed or the request could not be started
+	if (!Response.IsValid()) return false;
+	if (Response.Code == 401)
+	{
+		(Session ? Session : GetDefaultSession())->RefreshAccessToken();
+	}
+	//200 is valid response code here, as is 304 for conditional requests
+	if (Response.Code != 200 && Response.Code != 304)
+	{
+		//Debug messages
+#if WITH_LEADERBOARD_DIAGNOSTICS
+		if (bShowDebug && FLeaderboardDiagnostics::IsVisible())
 		{
-			FString ResponseString = Response->GetContentAsString();
-			AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this]()
-			{
-				std::lock_guard Lock(Mutex);
-				UE_LOG(LogTemp, Warning, TEXT("401 Unauthorized - Refreshing Access Token"));
-				RefreshAccessToken();
-			});
+			FLeaderboardDiagnostics::AddMessage(FString::Printf(TEXT("Error: Invalid Response Code: %d %s"), Response.Code, *Response.URL));
 		}
+#endif
+		return false;
 	}
+	return true;
 }
 
-void ULeaderboardController::GenerateOTPResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response,
-	bool bConnectedSuccessfully)
+bool ULeaderboardController::ValidAuthorization() const
 {
-	if (bConnectedSuccessfully && Response.IsValid() && Response->GetResponseCode() == 200)
+	return DefaultSession != nullptr && DefaultSession->ValidAuthorization();
+}
+
+FString ULeaderboardController::GenerateHmac(const FString& Message, const FString& Key)
+{
+	// Convert to UTF-8 for OpenSSL compatibility. Embedded nulls are kept, lengths are explicit
+	FTCHARToUTF8 MessageUtf8(*Message, Message.Len());
+	FTCHARToUTF8 KeyUtf8(*Key, Key.Len());
+
+	// Compute HMAC SHA-256 into our own buffer; without one OpenSSL uses a static buffer shared by every thread
+	unsigned char Hash[EVP_MAX_MD_SIZE];
+	unsigned int HashLength = 0;
+	if (HMAC(EVP_sha256(),
+			 KeyUtf8.Get(),
+			 KeyUtf8.Length(),
+			 reinterpret_cast<const unsigned char*>(MessageUtf8.Get()),
+			 MessageUtf8.Length(),
+			 Hash,
+			 &HashLength) == nullptr)
 	{
-		OnOtpSent.Broadcast();
+		UE_LOG(LogTemp, Error, TEXT("Error: HMAC computation failed"));
+		return FString();
 	}
+
+	// Base64 encode the hash
+	return FBase64::Encode(Hash, HashLength);
 }
 
-void ULeaderboardController::VerifyOTPResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response,
-	bool bConnectedSuccessfully)
+void ULeaderboardController::FinishDestroy()
 {
-	if (!ValidResponse(Response)) return;
-	//Read response content as JSON
-	TSharedPtr<FJsonObject> ResponseObj;
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-	FJsonSerializer::Deserialize(Reader, ResponseObj);
-	//Get Access Token
-	FString OutAccessToken;
-	if (ResponseObj->TryGetStringField("access", OutAccessToken))
+	//Outstanding requests must not call back into a destroyed controller
+	StopLiveLeaderboard();
+	FTSTicker::GetCoreTicker().RemoveTicker(ProfileFlushHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(RolloverHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(PrefetchHandle);
+	Scheduler.CancelAll();
+	if (!CommandLineRecordingPath.IsEmpty())
 	{
-		AccessToken = OutAccessToken;
+		StopRecording(CommandLineRecordingPath);
 	}
-	//Get Refresh Token
-	FString OutRefreshToken;
-	if (ResponseObj->TryGetStringField("refresh", OutRefreshToken))
+	UObject::FinishDestroy();
+	//Delete singleton. Other controllers (e.g. the automation tests' own) leave it alone
+	if (Instance == this)
 	{
-		RefreshToken = OutRefreshToken;
+		Instance = nullptr;
 	}
-	if (!AccessToken.IsEmpty() && !RefreshToken.IsEmpty())
+}
+
+void ULeaderboardController::GetUser(const FString& BearerToken)
+{
+	GetDefaultSession()->GetUser();
+}
+
+void ULeaderboardController::TopScoresResponseReceived(const FLeaderboardHttpResponse& Response, FLeaderboardQuery Query, ELeaderboardRequestPriority Priority, bool bConditional, FOnTopScoresComplete OnComplete)
+{
+	if (!ValidResponse(Response))
 	{
-		OnOtpVerified.Broadcast();
+		OnComplete(false, FScores());
+		return;
+	}
+	//Not modified, the cached board is still current and there is no body to parse
+	if (Response.Code == 304)
+	{
+		const TLeaderboardResponseCache<FScores>::FEntry* Cached = TopScoresCache.Find(Response.URL);
+		if (Cached == nullptr)
+		{
+			//Evicted or expired while in flight. Ask again without validators, a 304 to that is a broken server.
+			//The new request is not covered by the handle the caller got
+			TopScoresCache.Remove(Response.URL);
+			if (bConditional)
+			{
+				SubmitTopScores(Query, MoveTemp(OnComplete), Priority, false);
+			}
+			else
+			{
+				OnComplete(false, FScores());
+			}
+			return;
+		}
+		TopScoresCache.MarkRevalidated(Response.URL);
+		OnComplete(true, Cached->Value);
+		return;
+	}
+	//Convert JSON into custom struct to hold info
+	FScores AllScores;
+	if (ParseScores(Response.GetContentAsUtf8(), AllScores))
+	{
+		TopScoresCache.Store(Response.URL, FLeaderboardValidators::FromResponse(Response), AllScores, GetRolloverTimeToLive(Query));
+		StoreProfilesFromBoard(AllScores);
+		SeedPersonalBests(Query, AllScores);
+		OnComplete(true, AllScores);
+	} else
+	{
+		UE_LOG(LogTemp, Display, TEXT("Object Conversion Failed"));
+		OnComplete(false, FScores());
 	}
 }
 
-void ULeaderboardController::GetUserResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response,
-	bool bConnectedSuccessfully)
+bool ULeaderboardController::ParseScores(FUtf8StringView Content, FScores& OutScores)
 {
-	if (!ValidResponse(Response)) return;
+	//Read response content as JSON, straight from the HTTP buffer
+	OutScores = FScores();
+	TSharedPtr<FJsonObject> ResponseObj;
+	if (!LeaderboardJson::Parse(Content, ResponseObj)) return false;
+	return ParseScores(ResponseObj.ToSharedRef(), OutScores);
+}
+
+bool ULeaderboardController::ParseScores(FStringView Content, FScores& OutScores)
+{
+	//Pushed messages arrive as FString, converted so they get the same limits as responses
+	FTCHARToUTF8 Utf8(Content.GetData(), Content.Len());
+	return ParseScores(FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Utf8.Get()), Utf8.Length()), OutScores);
 }
 
-void ULeaderboardController::RefreshAccessTokenResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response,
-	bool bConnectedSuccessfully)
+bool ULeaderboardController::ParseScores(const TSharedRef<FJsonObject>& Object, FScores& OutScores)
 {
+	return FJsonObjectConverter::JsonObjectToUStruct<FScores>(Object, &OutScores);
 }
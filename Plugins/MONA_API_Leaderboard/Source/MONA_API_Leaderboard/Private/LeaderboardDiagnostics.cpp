@@ -0,0 +1,186 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardDiagnostics.h"
+
+#if WITH_LEADERBOARD_DIAGNOSTICS
+
+#include "LeaderboardController.h"
+#include "LeaderboardSession.h"
+#include "Debug/DebugDrawService.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "Engine/Font.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Base64.h"
+#include "Misc/StringBuilder.h"
+#include "Serialization/JsonSerializer.h"
+
+TArray<FLeaderboardDiagnostics::FMessage> FLeaderboardDiagnostics::Messages;
+FDelegateHandle FLeaderboardDiagnostics::DrawHandle;
+
+static int32 GLeaderboardDiagnostics = 0;
+static FAutoConsoleVariableRef CVarLeaderboardDiagnostics(
+	TEXT("Mona.Leaderboard.Diagnostics"),
+	GLeaderboardDiagnostics,
+	TEXT("1 shows the leaderboard diagnostics panel, 0 hides it"),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*)
+	{
+		FLeaderboardDiagnostics::SetVisible(GLeaderboardDiagnostics != 0);
+	}));
+
+namespace LeaderboardDiagnostics
+{
+	static double Percent(int32 Part, int32 Total)
+	{
+		return Total > 0 ? 100.0 * Part / Total : 0.0;
+	}
+
+	//exp claim of a JWT access token. False for anything else
+	static bool GetTokenExpiry(const FString& AccessToken, FDateTime& OutExpiry)
+	{
+		TArray<FString> Parts;
+		if (AccessToken.ParseIntoArray(Parts, TEXT("."), false) != 3) return false;
+		FString Payload = MoveTemp(Parts[1]);
+		while (Payload.Len() % 4 != 0)
+		{
+			Payload.AppendChar(TEXT('='));
+		}
+		TArray<uint8> Claims;
+		if (!FBase64::Decode(Payload, Claims, EBase64Mode::UrlSafe)) return false;
+		TSharedPtr<FJsonObject> ClaimsObj;
+		TSharedRef<TJsonReader<UTF8CHAR>> Reader = TJsonReaderFactory<UTF8CHAR>::CreateFromView(FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Claims.GetData()), Claims.Num()));
+		double Expiry = 0.0;
+		if (!FJsonSerializer::Deserialize(Reader, ClaimsObj) || !ClaimsObj.IsValid() || !ClaimsObj->TryGetNumberField(TEXT("exp"), Expiry)) return false;
+		OutExpiry = FDateTime::FromUnixTimestamp(static_cast<int64>(Expiry));
+		return true;
+	}
+}
+
+void FLeaderboardDiagnostics::SetVisible(bool bVisible)
+{
+	check(IsInGameThread());
+	GLeaderboardDiagnostics = bVisible ? 1 : 0;
+	if (bVisible == IsVisible()) return;
+	if (bVisible)
+	{
+		DrawHandle = UDebugDrawService::Register(TEXT("Game"), FDebugDrawDelegate::CreateStatic(&FLeaderboardDiagnostics::Draw));
+	}
+	else
+	{
+		UDebugDrawService::Unregister(DrawHandle);
+		DrawHandle.Reset();
+		Messages.Empty();
+	}
+}
+
+void FLeaderboardDiagnostics::AddMessage(FString&& Message, const FColor& Color, float DisplaySeconds)
+{
+	check(IsInGameThread());
+	if (Messages.Num() >= MaxMessages)
+	{
+		Messages.RemoveAt(0, 1, false);
+	}
+	Messages.Add({MoveTemp(Message), Color, FPlatformTime::Seconds() + DisplaySeconds});
+}
+
+void FLeaderboardDiagnostics::Draw(UCanvas* Canvas, APlayerController* PlayerController)
+{
+	using namespace LeaderboardDiagnostics;
+	if (Canvas == nullptr || GEngine == nullptr) return;
+	ULeaderboardController* Controller = ULeaderboardController::GetLeaderboardController();
+	UFont* Font = GEngine->GetSmallFont();
+	const float LineHeight = Font->GetMaxCharHeight() + 2.f;
+	float Y = 50.f;
+	TStringBuilder<256> Line;
+	auto DrawLine = [&](const FColor& Color)
+	{
+		Canvas->SetDrawColor(Color);
+		Canvas->DrawText(Font, FString(Line.ToView()), 10.f, Y);
+		Y += LineHeight;
+		Line.Reset();
+	};
+
+	//Requests
+	FLeaderboardRequestScheduler& Scheduler = Controller->GetScheduler();
+	Line.Appendf(TEXT("Mona Leaderboard  in flight %d/%d  queued %d"), Scheduler.GetNumInFlight(), Scheduler.GetMaxConcurrentRequests(), Scheduler.GetNumQueued());
+	DrawLine(FColor::White);
+	const UEnum* PriorityEnum = StaticEnum<ELeaderboardRequestPriority>();
+	Line << TEXT("Queues");
+	for (int32 Priority = 0; Priority < static_cast<int32>(ELeaderboardRequestPriority::Count); ++Priority)
+	{
+		Line.Appendf(TEXT("  %s %d"), *PriorityEnum->GetNameStringByIndex(Priority), Scheduler.GetNumQueued(static_cast<ELeaderboardRequestPriority>(Priority)));
+	}
+	DrawLine(FColor::White);
+
+	//Endpoints that were used at all
+	const FLeaderboardStats& Stats = Scheduler.GetStats();
+	for (int32 Index = 0; Index < static_cast<int32>(ELeaderboardEndpoint::Count); ++Index)
+	{
+		const FLeaderboardEndpointStats& Endpoint = Stats.Get(static_cast<ELeaderboardEndpoint>(Index));
+		if (Endpoint.NumRequests == 0) continue;
+		Line.Appendf(TEXT("%s  %d requests  %d failed  %d not modified  last %.0f ms"), LexToString(static_cast<ELeaderboardEndpoint>(Index)),
+			Endpoint.NumRequests, Endpoint.NumFailed, Endpoint.NumNotModified, Endpoint.LastLatency * 1000.0);
+		DrawLine(Endpoint.NumFailed > 0 ? FColor::Yellow : FColor::White);
+	}
+
+	//Caches. A board hit is a 304 that reused the cached board
+	const FLeaderboardEndpointStats& TopScores = Stats.Get(ELeaderboardEndpoint::TopScores);
+	const TLeaderboardResponseCache<FScores>& TopScoresCache = Controller->GetTopScoresCache();
+	Line.Appendf(TEXT("Board cache  %d boards  %.1f KB  %.0f%% hits"), TopScoresCache.Num(), TopScoresCache.GetUsedBytes() / 1024.0,
+		Percent(TopScores.NumNotModified, TopScores.NumRequests - TopScores.NumFailed));
+	DrawLine(FColor::White);
+	const FLeaderboardProfileCache& ProfileCache = Controller->GetProfileCache();
+	Line.Appendf(TEXT("Profile cache  %d profiles  %.1f KB  %.0f%% hits"), ProfileCache.Num(), ProfileCache.GetUsedBytes() / 1024.0,
+		Percent(ProfileCache.GetNumHits(), ProfileCache.GetNumHits() + ProfileCache.GetNumMisses()));
+	DrawLine(FColor::White);
+	const FLeaderboardMemoryBudget& MemoryBudget = Controller->GetMemoryBudget();
+	Line.Appendf(TEXT("Memory  %.1f / %.1f KB  live leaderboard %s"), MemoryBudget.GetUsedBytes() / 1024.0, MemoryBudget.GetBudgetBytes() / 1024.0,
+		Controller->IsLiveLeaderboardActive() ? TEXT("on") : TEXT("off"));
+	DrawLine(FColor::White);
+
+	//Tokens
+	auto DrawSession = [&](const ULeaderboardSession* Session)
+	{
+		FString AccessToken;
+		FString RefreshToken;
+		const bool bAuthorized = Session->GetTokens(AccessToken, RefreshToken);
+		Line.Appendf(TEXT("Session %s  "), Session->GetPlayerID().IsEmpty() ? TEXT("<default>") : *Session->GetPlayerID());
+		FDateTime Expiry;
+		if (!bAuthorized)
+		{
+			Line << TEXT("not authorized");
+			DrawLine(FColor::Yellow);
+		}
+		else if (!GetTokenExpiry(AccessToken, Expiry))
+		{
+			Line << TEXT("authorized, token expiry unknown");
+			DrawLine(FColor::White);
+		}
+		else if (Expiry <= FDateTime::UtcNow())
+		{
+			Line << TEXT("access token expired");
+			DrawLine(FColor::Red);
+		}
+		else
+		{
+			Line.Appendf(TEXT("access token expires in %s"), *(Expiry - FDateTime::UtcNow()).ToString(TEXT("%d.%h:%m:%s")));
+			DrawLine(FColor::Green);
+		}
+	};
+	DrawSession(Controller->GetDefaultSession());
+	for (const TPair<FString, TObjectPtr<ULeaderboardSession>>& Pair : Controller->GetSessions())
+	{
+		DrawSession(Pair.Value);
+	}
+
+	//Recent messages, newest last
+	const double Now = FPlatformTime::Seconds();
+	Messages.RemoveAll([Now](const FMessage& Message) { return Message.ExpiresTime <= Now; });
+	for (const FMessage& Message : Messages)
+	{
+		Line << Message.Text;
+		DrawLine(Message.Color);
+	}
+}
+
+#endif
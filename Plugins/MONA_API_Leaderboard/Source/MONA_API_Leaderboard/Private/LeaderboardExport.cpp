@@ -0,0 +1,381 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardExport.h"
+#include "HAL/FileManager.h"
+
+namespace LeaderboardColumnar
+{
+	static constexpr uint32 FileMagic = 0x4D4C4243; //"MLBC"
+	//2: board key in every block header
+	static constexpr uint32 FileVersion = 2;
+	static constexpr uint64 MaxStringBytes = 64 * 1024;
+
+	static const FDateTime UnixEpoch(1970, 1, 1);
+
+	static void WriteVarint(TArray<uint8>& Out, uint64 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add(static_cast<uint8>(Value | 0x80));
+			Value >>= 7;
+		}
+		Out.Add(static_cast<uint8>(Value));
+	}
+
+	static uint64 ZigZag(int64 Value)
+	{
+		return (static_cast<uint64>(Value) << 1) ^ static_cast<uint64>(Value >> 63);
+	}
+
+	static int64 UnZigZag(uint64 Value)
+	{
+		return static_cast<int64>(Value >> 1) ^ -static_cast<int64>(Value & 1);
+	}
+
+	//Unix milliseconds, 0 if the timestamp is missing or unparseable
+	static int64 ParseCreatedAt(const FString& CreatedAt)
+	{
+		FDateTime Date;
+		if (CreatedAt.IsEmpty() || !FDateTime::ParseIso8601(*CreatedAt, Date)) return 0;
+		return static_cast<int64>((Date - UnixEpoch).GetTotalMilliseconds());
+	}
+
+	static FString FormatCreatedAt(int64 Milliseconds)
+	{
+		if (Milliseconds == 0) return FString();
+		return (UnixEpoch + FTimespan::FromMilliseconds(static_cast<double>(Milliseconds))).ToIso8601();
+	}
+
+	//Bounds-checked view over one block's payload. Every read fails once anything was out of range
+	struct FCursor
+	{
+		TArrayView<const uint8> Data;
+		int32 Position = 0;
+		bool bError = false;
+
+		uint64 ReadVarint()
+		{
+			uint64 Value = 0;
+			for (int32 Shift = 0; Shift < 64; Shift += 7)
+			{
+				if (Position >= Data.Num())
+				{
+					bError = true;
+					return 0;
+				}
+				const uint8 Byte = Data[Position++];
+				Value |= static_cast<uint64>(Byte & 0x7F) << Shift;
+				if ((Byte & 0x80) == 0) return Value;
+			}
+			//More than ten bytes is not a varint we wrote
+			bError = true;
+			return 0;
+		}
+
+		bool ReadString(FString& Out)
+		{
+			const uint64 Length = ReadVarint();
+			if (bError || Length > MaxStringBytes || Length > static_cast<uint64>(Data.Num() - Position))
+			{
+				bError = true;
+				return false;
+			}
+			Out = FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Data.GetData() + Position), static_cast<int32>(Length)));
+			Position += static_cast<int32>(Length);
+			return true;
+		}
+
+		//Delta column: each value relative to the one before it
+		template<typename ValueType>
+		void ReadDeltas(TArray<FUserInfo>& Rows, ValueType FUserInfo::* Field)
+		{
+			int64 Previous = 0;
+			for (FUserInfo& Row : Rows)
+			{
+				Previous += UnZigZag(ReadVarint());
+				Row.*Field = static_cast<ValueType>(Previous);
+			}
+		}
+	};
+}
+
+FLeaderboardColumnarWriter::FLeaderboardColumnarWriter(int32 InRowsPerBlock)
+	: RowsPerBlock(FMath::Clamp(InRowsPerBlock, 1, FLeaderboardColumnarReader::MaxRowsPerBlock))
+{
+}
+
+FLeaderboardColumnarWriter::~FLeaderboardColumnarWriter()
+{
+	if (Archive.IsValid())
+	{
+		Close();
+	}
+}
+
+bool FLeaderboardColumnarWriter::Open(const FString& Path)
+{
+	Archive.Reset(IFileManager::Get().CreateFileWriter(*Path));
+	if (!Archive.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Leaderboard export: cannot write %s"), *Path);
+		return false;
+	}
+	uint32 Magic = LeaderboardColumnar::FileMagic;
+	uint32 Version = LeaderboardColumnar::FileVersion;
+	*Archive << Magic << Version;
+	Pending.Reset(RowsPerBlock);
+	BoardKey.Reset();
+	NumRows = 0;
+	return true;
+}
+
+void FLeaderboardColumnarWriter::BeginBoard(const FString& Key)
+{
+	if (!Archive.IsValid()) return;
+	FlushBlock();
+	BoardKey = Key;
+}
+
+void FLeaderboardColumnarWriter::Add(const FUserInfo& Row)
+{
+	if (!Archive.IsValid()) return;
+	Pending.Add(Row);
+	++NumRows;
+	if (Pending.Num() >= RowsPerBlock)
+	{
+		FlushBlock();
+	}
+}
+
+void FLeaderboardColumnarWriter::Add(const FScores& Scores)
+{
+	for (const FUserInfo& Row : Scores.Items)
+	{
+		Add(Row);
+	}
+}
+
+bool FLeaderboardColumnarWriter::Close()
+{
+	if (!Archive.IsValid()) return false;
+	FlushBlock();
+	//End marker
+	uint32 EndRows = 0;
+	uint32 EndKeyBytes = 0;
+	uint32 EndBytes = 0;
+	*Archive << EndRows << EndKeyBytes << EndBytes;
+	const bool bSuccess = Archive->Close() && !Archive->IsError();
+	Archive.Reset();
+	return bSuccess;
+}
+
+void FLeaderboardColumnarWriter::FlushBlock()
+{
+	if (Pending.Num() == 0) return;
+	EncodeBlock(Pending, Payload);
+	FTCHARToUTF8 Key(*BoardKey, BoardKey.Len());
+	uint32 BlockRows = Pending.Num();
+	uint32 KeyBytes = FMath::Min<int32>(Key.Length(), LeaderboardColumnar::MaxStringBytes);
+	uint32 BlockBytes = Payload.Num();
+	*Archive << BlockRows << KeyBytes << BlockBytes;
+	Archive->Serialize(const_cast<ANSICHAR*>(Key.Get()), KeyBytes);
+	Archive->Serialize(Payload.GetData(), Payload.Num());
+	Pending.Reset();
+}
+
+void FLeaderboardColumnarWriter::EncodeBlock(TArrayView<const FUserInfo> Rows, TArray<uint8>& OutPayload)
+{
+	using namespace LeaderboardColumnar;
+	OutPayload.Reset();
+
+	//Block-local dictionary, so a reader never needs strings from another block
+	TMap<FString, int32> Dictionary;
+	TArray<const FString*> Strings;
+	TArray<int32> Indices;
+	Indices.Reserve(Rows.Num() * 3);
+	auto Intern = [&](const FString& Value)
+	{
+		int32& Index = Dictionary.FindOrAdd(Value, INDEX_NONE);
+		if (Index == INDEX_NONE)
+		{
+			Index = Strings.Num();
+			Strings.Add(&Value);
+		}
+		Indices.Add(Index);
+	};
+	for (const FUserInfo& Row : Rows)
+	{
+		Intern(Row.User.Username);
+		Intern(Row.User.Name);
+		Intern(Row.Topic);
+	}
+	WriteVarint(OutPayload, Strings.Num());
+	for (const FString* String : Strings)
+	{
+		FTCHARToUTF8 Utf8(**String, String->Len());
+		const int32 Length = FMath::Min<int32>(Utf8.Length(), MaxStringBytes);
+		WriteVarint(OutPayload, Length);
+		OutPayload.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Length);
+	}
+
+	auto WriteDeltas = [&](auto&& GetValue)
+	{
+		int64 Previous = 0;
+		for (const FUserInfo& Row : Rows)
+		{
+			const int64 Value = GetValue(Row);
+			WriteVarint(OutPayload, ZigZag(Value - Previous));
+			Previous = Value;
+		}
+	};
+	WriteDeltas([](const FUserInfo& Row) { return static_cast<int64>(Row.ID); });
+	WriteDeltas([](const FUserInfo& Row) { return static_cast<int64>(Row.Rank); });
+	WriteDeltas([](const FUserInfo& Row) { return static_cast<int64>(Row.Score); });
+	WriteDeltas([](const FUserInfo& Row) { return ParseCreatedAt(Row.Created_At); });
+
+	//Username, name and topic columns, one after the other
+	for (int32 Column = 0; Column < 3; ++Column)
+	{
+		for (int32 Row = 0; Row < Rows.Num(); ++Row)
+		{
+			WriteVarint(OutPayload, Indices[Row * 3 + Column]);
+		}
+	}
+}
+
+bool FLeaderboardColumnarReader::Open(const FString& Path)
+{
+	bError = false;
+	bEnded = false;
+	BoardKey.Reset();
+	Archive.Reset(IFileManager::Get().CreateFileReader(*Path));
+	if (!Archive.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Leaderboard export: cannot read %s"), *Path);
+		bError = true;
+		return false;
+	}
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	*Archive << Magic << Version;
+	if (Archive->IsError() || Magic != LeaderboardColumnar::FileMagic || Version != LeaderboardColumnar::FileVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Leaderboard export: %s is not a board file this version can read"), *Path);
+		Archive.Reset();
+		bError = true;
+		return false;
+	}
+	return true;
+}
+
+bool FLeaderboardColumnarReader::ReadBlock(TArray<FUserInfo>& OutRows)
+{
+	OutRows.Reset();
+	if (!Archive.IsValid() || bError || bEnded) return false;
+	uint32 BlockRows = 0;
+	uint32 KeyBytes = 0;
+	uint32 BlockBytes = 0;
+	*Archive << BlockRows << KeyBytes << BlockBytes;
+	if (Archive->IsError() || BlockRows > MaxRowsPerBlock || KeyBytes > LeaderboardColumnar::MaxStringBytes || BlockBytes > MaxBlockBytes
+		|| static_cast<uint64>(KeyBytes) + BlockBytes > static_cast<uint64>(Archive->TotalSize() - Archive->Tell()))
+	{
+		bError = true;
+		return false;
+	}
+	if (BlockRows == 0)
+	{
+		bEnded = true;
+		return false;
+	}
+	Payload.SetNumUninitialized(KeyBytes, false);
+	Archive->Serialize(Payload.GetData(), KeyBytes);
+	BoardKey = FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Payload.GetData()), KeyBytes));
+	Payload.SetNumUninitialized(BlockBytes, false);
+	Archive->Serialize(Payload.GetData(), BlockBytes);
+	if (Archive->IsError() || !DecodeBlock(Payload, BlockRows, OutRows))
+	{
+		OutRows.Reset();
+		bError = true;
+		return false;
+	}
+	return true;
+}
+
+bool FLeaderboardColumnarReader::DecodeBlock(TArrayView<const uint8> Payload, int32 NumRows, TArray<FUserInfo>& OutRows)
+{
+	using namespace LeaderboardColumnar;
+	OutRows.Reset();
+	//Every row takes at least one byte per column
+	if (NumRows < 0 || NumRows > MaxRowsPerBlock || static_cast<int64>(NumRows) * 7 > Payload.Num()) return false;
+	FCursor Cursor{Payload};
+
+	const uint64 NumStrings = Cursor.ReadVarint();
+	//Every string takes at least its length byte
+	if (Cursor.bError || NumStrings > static_cast<uint64>(Payload.Num())) return false;
+	TArray<FString> Strings;
+	Strings.SetNum(static_cast<int32>(NumStrings));
+	for (FString& String : Strings)
+	{
+		if (!Cursor.ReadString(String)) return false;
+	}
+
+	OutRows.SetNum(NumRows);
+	Cursor.ReadDeltas(OutRows, &FUserInfo::ID);
+	Cursor.ReadDeltas(OutRows, &FUserInfo::Rank);
+	Cursor.ReadDeltas(OutRows, &FUserInfo::Score);
+	int64 CreatedAt = 0;
+	for (FUserInfo& Row : OutRows)
+	{
+		CreatedAt += UnZigZag(Cursor.ReadVarint());
+		Row.Created_At = FormatCreatedAt(CreatedAt);
+	}
+	for (int32 Column = 0; Column < 3; ++Column)
+	{
+		for (FUserInfo& Row : OutRows)
+		{
+			const uint64 Index = Cursor.ReadVarint();
+			if (Cursor.bError || Index >= static_cast<uint64>(Strings.Num()))
+			{
+				OutRows.Reset();
+				return false;
+			}
+			FString& Field = Column == 0 ? Row.User.Username : Column == 1 ? Row.User.Name : Row.Topic;
+			Field = Strings[static_cast<int32>(Index)];
+		}
+	}
+	if (Cursor.bError || Cursor.Position != Payload.Num())
+	{
+		OutRows.Reset();
+		return false;
+	}
+	return true;
+}
+
+bool FLeaderboardColumnarReader::LoadFile(const FString& Path, FScores& OutScores)
+{
+	OutScores = FScores();
+	FLeaderboardColumnarReader Reader;
+	if (!Reader.Open(Path)) return false;
+	TArray<FUserInfo> Block;
+	while (Reader.ReadBlock(Block))
+	{
+		OutScores.Items.Append(MoveTemp(Block));
+	}
+	OutScores.Count = OutScores.Items.Num();
+	return !Reader.HasError();
+}
+
+bool FLeaderboardColumnarReader::LoadBoards(const FString& Path, TMap<FString, FScores>& OutBoards)
+{
+	OutBoards.Reset();
+	FLeaderboardColumnarReader Reader;
+	if (!Reader.Open(Path)) return false;
+	TArray<FUserInfo> Block;
+	while (Reader.ReadBlock(Block))
+	{
+		FScores& Board = OutBoards.FindOrAdd(Reader.GetBoardKey());
+		Board.Items.Append(MoveTemp(Block));
+		Board.Count = Board.Items.Num();
+	}
+	return !Reader.HasError();
+}
@@ -0,0 +1,547 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardFuzzCommandlet.h"
+#include "LeaderboardController.h"
+#include "LeaderboardSession.h"
+#include "LeaderboardExport.h"
+#include "LeaderboardAllocationCounter.h"
+#include "LeaderboardJsonParse.h"
+#include "HAL/FileManager.h"
+#include "HAL/Thread.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+namespace LeaderboardFuzz
+{
+	//Enough failures to investigate without filling the disk when one bug trips on every input
+	static constexpr int32 MaxArtifacts = 100;
+
+	//Bytes that change what a JSON or varint parser does next
+	static const uint8 InterestingBytes[] = {0x00, 0x7F, 0x80, 0xFF, '"', '\\', '{', '}', '[', ']', ',', ':', '-', '0', '9', 'e', '.'};
+
+	static void AddText(TArray<TArray<uint8>>& OutInputs, const ANSICHAR* Text)
+	{
+		OutInputs.Emplace(reinterpret_cast<const uint8*>(Text), FCStringAnsi::Strlen(Text));
+	}
+
+	static TArray<uint8>& AddRepeated(TArray<TArray<uint8>>& OutInputs, const ANSICHAR* Text, int32 Count)
+	{
+		const int32 Length = FCStringAnsi::Strlen(Text);
+		TArray<uint8>& Input = OutInputs.AddDefaulted_GetRef();
+		Input.Reserve(Length * Count);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Input.Append(reinterpret_cast<const uint8*>(Text), Length);
+		}
+		return Input;
+	}
+
+	static void MakeRows(int32 NumRows, TArray<FUserInfo>& OutRows)
+	{
+		OutRows.SetNum(NumRows);
+		for (int32 Index = 0; Index < NumRows; ++Index)
+		{
+			FUserInfo& Row = OutRows[Index];
+			Row.ID = 1000 + Index;
+			Row.Rank = Index + 1;
+			Row.Score = 100000 - Index * 7;
+			Row.Topic = TEXT("level1");
+			Row.Created_At = TEXT("2024-05-01T10:00:00.000Z");
+			Row.User.Username = FString::Printf(TEXT("player%d"), Index);
+			Row.User.Name = FString::Printf(TEXT("Player %d"), Index);
+		}
+	}
+
+	//Row count in the first two bytes, then the payload, as the Columnar target reads it
+	static void AddBlock(TArray<TArray<uint8>>& OutInputs, int32 NumRows, TArrayView<const uint8> Payload)
+	{
+		TArray<uint8>& Input = OutInputs.AddDefaulted_GetRef();
+		Input.Add(static_cast<uint8>(NumRows & 0xFF));
+		Input.Add(static_cast<uint8>((NumRows >> 8) & 0xFF));
+		Input.Append(Payload.GetData(), Payload.Num());
+	}
+}
+
+ULeaderboardFuzzCommandlet::ULeaderboardFuzzCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+const TCHAR* ULeaderboardFuzzCommandlet::GetTargetName(ETarget Target)
+{
+	switch (Target)
+	{
+		case ETarget::TopScores: return TEXT("TopScores");
+		case ETarget::Tokens: return TEXT("Tokens");
+		case ETarget::User: return TEXT("User");
+		case ETarget::Columnar: return TEXT("Columnar");
+		case ETarget::Hmac: return TEXT("Hmac");
+		default: return TEXT("Unknown");
+	}
+}
+
+int32 ULeaderboardFuzzCommandlet::Main(const FString& Params)
+{
+	FString TargetName = TEXT("All");
+	FString CorpusDir;
+	FString InputPath;
+	int32 Iterations = 100000;
+	float Duration = 0.f;
+	int32 Seed = 0;
+	int32 MemoryLimitMB = 64;
+	ArtifactsDir = FPaths::ProjectSavedDir() / TEXT("LeaderboardFuzz");
+	FParse::Value(*Params, TEXT("Target="), TargetName);
+	FParse::Value(*Params, TEXT("Corpus="), CorpusDir);
+	FParse::Value(*Params, TEXT("Artifacts="), ArtifactsDir);
+	FParse::Value(*Params, TEXT("Input="), InputPath);
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("MaxLen="), MaxLen);
+	FParse::Value(*Params, TEXT("TimeLimitMs="), TimeLimitMs);
+	FParse::Value(*Params, TEXT("MsPerMB="), MsPerMB);
+	FParse::Value(*Params, TEXT("MemoryLimitMB="), MemoryLimitMB);
+	FParse::Value(*Params, TEXT("Timeout="), TimeoutSeconds);
+	MaxLen = FMath::Max(1, MaxLen);
+	MemoryLimitBytes = static_cast<int64>(FMath::Max(1, MemoryLimitMB)) * 1024 * 1024;
+
+	TArray<ETarget> Targets;
+	for (int32 Index = 0; Index < static_cast<int32>(ETarget::Count); ++Index)
+	{
+		if (TargetName.Equals(TEXT("All"), ESearchCase::IgnoreCase) || TargetName.Equals(GetTargetName(static_cast<ETarget>(Index)), ESearchCase::IgnoreCase))
+		{
+			Targets.Add(static_cast<ETarget>(Index));
+		}
+	}
+	if (Targets.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("LeaderboardFuzz: unknown target '%s'"), *TargetName);
+		return 1;
+	}
+	if (Seed == 0)
+	{
+		Seed = static_cast<int32>(FPlatformTime::Cycles());
+	}
+	Random.Initialize(Seed);
+	UE_LOG(LogTemp, Display, TEXT("LeaderboardFuzz: seed %d, artifacts in %s"), Seed, *ArtifactsDir);
+
+	//Refused inputs log a warning each, only errors are worth printing here
+	const ELogVerbosity::Type PreviousVerbosity = LogTemp.GetVerbosity();
+	LogTemp.SetVerbosity(ELogVerbosity::Error);
+	const FDelegateHandle CrashHandle = FCoreDelegates::OnHandleSystemError.AddLambda([this]() { HandleCrash(); });
+	if (!FLeaderboardAllocationCounter::Install())
+	{
+		UE_LOG(LogTemp, Error, TEXT("LeaderboardFuzz: no byte counts from this allocator, memory limits are off"));
+	}
+	StopWatchdog = FPlatformProcess::GetSynchEventFromPool(true);
+	FThread WatchdogThread(TEXT("LeaderboardFuzzWatchdog"), [this]() { Watchdog(); });
+
+	if (!InputPath.IsEmpty())
+	{
+		//Reproduce a saved artifact
+		TArray<uint8> Input;
+		if (!FFileHelper::LoadFileToArray(Input, *InputPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("LeaderboardFuzz: cannot read %s"), *InputPath);
+		}
+		for (ETarget Target : Targets)
+		{
+			Execute(Target, Input);
+		}
+	}
+	else
+	{
+		const int32 IterationsPerTarget = FMath::Max(1, Iterations / Targets.Num());
+		const double SecondsPerTarget = Duration / Targets.Num();
+		for (ETarget Target : Targets)
+		{
+			TArray<TArray<uint8>> Stress;
+			AddStressInputs(Target, Stress);
+			for (const TArray<uint8>& Input : Stress)
+			{
+				Execute(Target, Input);
+			}
+
+			TArray<TArray<uint8>> Pool;
+			AddSeeds(Target, Pool);
+			if (!CorpusDir.IsEmpty())
+			{
+				//One subdirectory per target, e.g. <Corpus>/TopScores/*
+				const FString TargetDir = CorpusDir / GetTargetName(Target);
+				TArray<FString> Files;
+				IFileManager::Get().FindFiles(Files, *(TargetDir / TEXT("*")), true, false);
+				for (const FString& File : Files)
+				{
+					TArray<uint8>& Input = Pool.AddDefaulted_GetRef();
+					if (!FFileHelper::LoadFileToArray(Input, *(TargetDir / File)))
+					{
+						Pool.Pop();
+					}
+				}
+			}
+			for (const TArray<uint8>& Input : Pool)
+			{
+				Execute(Target, Input);
+			}
+
+			const double EndTime = FPlatformTime::Seconds() + SecondsPerTarget;
+			for (int32 Iteration = 0; Duration > 0.f ? FPlatformTime::Seconds() < EndTime : Iteration < IterationsPerTarget; ++Iteration)
+			{
+				TArray<uint8> Input = Pool[Random.RandHelper(Pool.Num())];
+				Mutate(Input, Pool);
+				Execute(Target, Input);
+			}
+		}
+	}
+
+	StopWatchdog->Trigger();
+	WatchdogThread.Join();
+	FPlatformProcess::ReturnSynchEventToPool(StopWatchdog);
+	StopWatchdog = nullptr;
+	FLeaderboardAllocationCounter::Uninstall();
+	FCoreDelegates::OnHandleSystemError.Remove(CrashHandle);
+	LogTemp.SetVerbosity(PreviousVerbosity);
+	return Report() ? 0 : 1;
+}
+
+bool ULeaderboardFuzzCommandlet::RunTarget(ETarget Target, TArrayView<const uint8> Input, bool& bOutAccepted)
+{
+	const FUtf8StringView Content(reinterpret_cast<const UTF8CHAR*>(Input.GetData()), Input.Num());
+	bOutAccepted = false;
+	switch (Target)
+	{
+		case ETarget::TopScores:
+		{
+			FScores Scores;
+			bOutAccepted = ULeaderboardController::ParseScores(Content, Scores);
+			return true;
+		}
+		case ETarget::Tokens:
+		{
+			FString AccessToken;
+			FString RefreshToken;
+			bOutAccepted = ULeaderboardSession::ParseTokens(Content, AccessToken, RefreshToken);
+			//Nothing may leak out of a refused body
+			return bOutAccepted || (AccessToken.IsEmpty() && RefreshToken.IsEmpty());
+		}
+		case ETarget::User:
+		{
+			FUser User;
+			bOutAccepted = ULeaderboardSession::ParseUser(Content, User);
+			return true;
+		}
+		case ETarget::Columnar:
+		{
+			if (Input.Num() < 2) return true;
+			const int32 NumRows = Input[0] | (Input[1] << 8);
+			TArray<FUserInfo> Rows;
+			bOutAccepted = FLeaderboardColumnarReader::DecodeBlock(Input.RightChop(2), NumRows, Rows);
+			if (!bOutAccepted) return Rows.Num() == 0;
+			//Whatever decodes must survive a round trip with the same rows and scores
+			TArray<uint8> Payload;
+			FLeaderboardColumnarWriter::EncodeBlock(Rows, Payload);
+			TArray<FUserInfo> RoundTrip;
+			if (!FLeaderboardColumnarReader::DecodeBlock(Payload, Rows.Num(), RoundTrip) || RoundTrip.Num() != Rows.Num()) return false;
+			for (int32 Index = 0; Index < Rows.Num(); ++Index)
+			{
+				if (RoundTrip[Index].ID != Rows[Index].ID || RoundTrip[Index].Rank != Rows[Index].Rank || RoundTrip[Index].Score != Rows[Index].Score) return false;
+			}
+			return true;
+		}
+		case ETarget::Hmac:
+		{
+			//First byte picks how much of the rest is key, the remainder is the message
+			if (Input.Num() == 0) return true;
+			const int32 KeyLength = FMath::Min<int32>(Input[0], Input.Num() - 1);
+			const FString Key(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Input.GetData() + 1), KeyLength));
+			const FString Message(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Input.GetData() + 1 + KeyLength), Input.Num() - 1 - KeyLength));
+			const FString Signature = ULeaderboardController::GenerateHmac(Message, Key);
+			bOutAccepted = true;
+			//Base64 of a SHA-256 digest, the same every time
+			return Signature.Len() == 44 && Signature == ULeaderboardController::GenerateHmac(Message, Key);
+		}
+		default:
+			return true;
+	}
+}
+
+void ULeaderboardFuzzCommandlet::AddSeeds(ETarget Target, TArray<TArray<uint8>>& OutSeeds)
+{
+	using namespace LeaderboardFuzz;
+	switch (Target)
+	{
+		case ETarget::TopScores:
+			AddText(OutSeeds, R"({"count":2,"items":[{"id":1,"rank":1,"score":120,"topic":"level1","created_at":"2024-05-01T10:00:00.000Z","user":{"username":"alice","name":"Alice"}},{"id":2,"rank":2,"score":90,"topic":"level1","created_at":"2024-05-01T11:00:00.000Z","user":{"username":"bob","name":"Bob"}}]})");
+			AddText(OutSeeds, R"({"count":0,"items":[]})");
+			break;
+		case ETarget::Tokens:
+			AddText(OutSeeds, R"({"access":"eyJhbGciOiJIUzI1NiJ9.eyJleHAiOjE3MDAwMDAwMDB9.c2ln","refresh":"eyJhbGciOiJIUzI1NiJ9.e30.c2ln"})");
+			AddText(OutSeeds, R"({"access":"a\u0000b","refresh":null})");
+			break;
+		case ETarget::User:
+			AddText(OutSeeds, R"({"username":"alice","name":"Al\u00efce"})");
+			break;
+		case ETarget::Columnar:
+		{
+			TArray<FUserInfo> Rows;
+			MakeRows(3, Rows);
+			TArray<uint8> Payload;
+			FLeaderboardColumnarWriter::EncodeBlock(Rows, Payload);
+			AddBlock(OutSeeds, Rows.Num(), Payload);
+			break;
+		}
+		case ETarget::Hmac:
+		{
+			TArray<uint8>& Input = OutSeeds.AddDefaulted_GetRef();
+			Input.Add(16);
+			Input.Append(reinterpret_cast<const uint8*>("0123456789abcdef1700000000:120:level1"), 37);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+void ULeaderboardFuzzCommandlet::AddStressInputs(ETarget Target, TArray<TArray<uint8>>& OutInputs)
+{
+	using namespace LeaderboardFuzz;
+	switch (Target)
+	{
+		case ETarget::TopScores:
+		{
+			//A large but legitimate board has to parse in time proportional to its size
+			TArray<uint8>& Board = OutInputs.AddDefaulted_GetRef();
+			const ANSICHAR* Head = R"({"count":20000,"items":[)";
+			Board.Append(reinterpret_cast<const uint8*>(Head), FCStringAnsi::Strlen(Head));
+			for (int32 Index = 0; Index < 20000; ++Index)
+			{
+				const FString Row = FString::Printf(TEXT("%s{\"id\":%d,\"rank\":%d,\"score\":%d,\"topic\":\"level1\",\"created_at\":\"2024-05-01T10:00:00.000Z\",\"user\":{\"username\":\"player%d\",\"name\":\"Player %d\"}}"),
+					Index > 0 ? TEXT(",") : TEXT(""), Index, Index + 1, 100000 - Index, Index, Index);
+				FTCHARToUTF8 Utf8(*Row, Row.Len());
+				Board.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+			}
+			Board.Append(reinterpret_cast<const uint8*>("]}"), 2);
+			//Past the size limit, deeper than the nesting limit, one huge string
+			AddRepeated(OutInputs, " ", LeaderboardJson::MaxResponseBytes + 1);
+			AddRepeated(OutInputs, "[", 1000000);
+			TArray<uint8>& LongString = AddRepeated(OutInputs, "a", 4 * 1024 * 1024);
+			LongString.Insert(reinterpret_cast<const uint8*>(R"({"items":[{"topic":")"), 20, 0);
+			break;
+		}
+		case ETarget::Tokens:
+		case ETarget::User:
+		{
+			AddRepeated(OutInputs, " ", ULeaderboardSession::MaxAuthResponseBytes + 1);
+			AddRepeated(OutInputs, "{\"a\":", 10000);
+			TArray<uint8>& LongToken = AddRepeated(OutInputs, "a", ULeaderboardSession::MaxAuthResponseBytes - 16);
+			LongToken.Insert(reinterpret_cast<const uint8*>(R"({"access":")"), 11, 0);
+			LongToken.Append(reinterpret_cast<const uint8*>(R"("})"), 2);
+			break;
+		}
+		case ETarget::Columnar:
+		{
+			//Headers that claim far more than the payload holds must fail without allocating for the claim
+			TArray<uint8> Payload;
+			Payload.Add(0xFF);
+			Payload.Add(0xFF);
+			Payload.Add(0xFF);
+			Payload.Add(0x7F);
+			AddBlock(OutInputs, 0xFFFF, Payload);
+			TArray<FUserInfo> Rows;
+			MakeRows(0xFFFF, Rows);
+			FLeaderboardColumnarWriter::EncodeBlock(Rows, Payload);
+			AddBlock(OutInputs, Rows.Num(), Payload);
+			break;
+		}
+		case ETarget::Hmac:
+		{
+			//Keys longer than the SHA-256 block are hashed first; a long message of bytes that are never valid UTF-8
+			TArray<uint8>& LongKey = AddRepeated(OutInputs, "k", 255 + 1024 * 1024);
+			LongKey[0] = 255;
+			AddRepeated(OutInputs, "\xF0", 1024 * 1024);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+void ULeaderboardFuzzCommandlet::Mutate(TArray<uint8>& Input, const TArray<TArray<uint8>>& Pool)
+{
+	using namespace LeaderboardFuzz;
+	const int32 NumMutations = 1 + Random.RandHelper(4);
+	for (int32 Mutation = 0; Mutation < NumMutations; ++Mutation)
+	{
+		switch (Random.RandHelper(8))
+		{
+			case 0: //Flip a bit
+				if (Input.Num() > 0)
+				{
+					Input[Random.RandHelper(Input.Num())] ^= static_cast<uint8>(1 << Random.RandHelper(8));
+				}
+				break;
+			case 1: //A byte the parser cares about
+				if (Input.Num() > 0)
+				{
+					Input[Random.RandHelper(Input.Num())] = InterestingBytes[Random.RandHelper(static_cast<int32>(UE_ARRAY_COUNT(InterestingBytes)))];
+				}
+				break;
+			case 2: //Insert random bytes
+			{
+				const int32 Count = 1 + Random.RandHelper(8);
+				const int32 At = Random.RandHelper(Input.Num() + 1);
+				Input.InsertUninitialized(At, Count);
+				for (int32 Index = 0; Index < Count; ++Index)
+				{
+					Input[At + Index] = static_cast<uint8>(Random.RandHelper(256));
+				}
+				break;
+			}
+			case 3: //Erase a range
+				if (Input.Num() > 0)
+				{
+					const int32 At = Random.RandHelper(Input.Num());
+					Input.RemoveAt(At, 1 + Random.RandHelper(FMath::Min(Input.Num() - At, 16)), false);
+				}
+				break;
+			case 4: //Truncate
+				Input.SetNum(Random.RandHelper(Input.Num() + 1), false);
+				break;
+			case 5: //Repeat a chunk, e.g. one array element many times over
+				if (Input.Num() > 0)
+				{
+					const int32 At = Random.RandHelper(Input.Num());
+					const TArray<uint8> Chunk(Input.GetData() + At, 1 + Random.RandHelper(FMath::Min(Input.Num() - At, 64)));
+					const int32 Repeats = 1 + Random.RandHelper(16);
+					for (int32 Index = 0; Index < Repeats; ++Index)
+					{
+						Input.Insert(Chunk, At);
+					}
+				}
+				break;
+			case 6: //Splice in part of another input
+			{
+				const TArray<uint8>& Other = Pool[Random.RandHelper(Pool.Num())];
+				if (Other.Num() > 0 && &Other != &Input)
+				{
+					const int32 From = Random.RandHelper(Other.Num());
+					Input.Insert(Other.GetData() + From, 1 + Random.RandHelper(Other.Num() - From), Random.RandHelper(Input.Num() + 1));
+				}
+				break;
+			}
+			case 7: //Deep nesting
+			{
+				const int32 Depth = 1 + Random.RandHelper(256);
+				const int32 At = Random.RandHelper(Input.Num() + 1);
+				const uint8 Open = Random.RandHelper(2) ? '[' : '{';
+				Input.InsertUninitialized(At, Depth);
+				FMemory::Memset(Input.GetData() + At, Open, Depth);
+				break;
+			}
+			default:
+				break;
+		}
+	}
+	if (Input.Num() > MaxLen)
+	{
+		Input.SetNum(MaxLen, false);
+	}
+}
+
+void ULeaderboardFuzzCommandlet::Execute(ETarget Target, const TArray<uint8>& Input)
+{
+	FTargetStats& TargetStats = Stats[static_cast<int32>(Target)];
+	const double StartTime = FPlatformTime::Seconds();
+	{
+		FScopeLock Lock(&CurrentInputLock);
+		CurrentInput = &Input;
+		CurrentTarget = Target;
+		CurrentInputStartTime = StartTime;
+	}
+	bool bAccepted = false;
+	const FLeaderboardAllocationCounter::FScope Allocations;
+	const bool bValid = RunTarget(Target, Input, bAccepted);
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	const int64 PeakGrowth = Allocations.GetPeakBytes();
+	{
+		FScopeLock Lock(&CurrentInputLock);
+		CurrentInput = nullptr;
+	}
+
+	TargetStats.NumInputs++;
+	TargetStats.NumAccepted += bAccepted ? 1 : 0;
+	TargetStats.TotalSeconds += Seconds;
+	TargetStats.MaxSeconds = FMath::Max(TargetStats.MaxSeconds, Seconds);
+
+	//Bigger inputs get proportionally more time, so only super-linear paths trip the limit
+	const double AllowedMs = TimeLimitMs + MsPerMB * Input.Num() / (1024.0 * 1024.0);
+	const TCHAR* Failure = !bValid ? TEXT("invariant")
+		: Seconds * 1000.0 > AllowedMs ? TEXT("slow")
+		: PeakGrowth > MemoryLimitBytes ? TEXT("memory")
+		: nullptr;
+	if (Failure)
+	{
+		TargetStats.NumFailed++;
+		UE_LOG(LogTemp, Error, TEXT("LeaderboardFuzz: %s input of %d bytes failed (%s), %.1f ms, peak +%lld KB"),
+			GetTargetName(Target), Input.Num(), Failure, Seconds * 1000.0, PeakGrowth / 1024);
+		SaveArtifact(Target, Failure, Input);
+	}
+}
+
+void ULeaderboardFuzzCommandlet::SaveArtifact(ETarget Target, const TCHAR* Reason, const TArray<uint8>& Input)
+{
+	if (NumArtifacts >= LeaderboardFuzz::MaxArtifacts) return;
+	const FString Path = ArtifactsDir / FString::Printf(TEXT("%s-%s-%d.bin"), Reason, GetTargetName(Target), NumArtifacts++);
+	if (FFileHelper::SaveArrayToFile(Input, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("LeaderboardFuzz: saved %s, replay with -Target=%s -Input=\"%s\""), *Path, GetTargetName(Target), *Path);
+	}
+}
+
+void ULeaderboardFuzzCommandlet::HandleCrash()
+{
+	if (CurrentInput)
+	{
+		SaveArtifact(CurrentTarget, TEXT("crash"), *CurrentInput);
+	}
+}
+
+void ULeaderboardFuzzCommandlet::Watchdog()
+{
+	//Checked often enough that a hang is caught within a few percent of the timeout
+	while (TimeoutSeconds > 0.0 && !StopWatchdog->Wait(FTimespan::FromMilliseconds(FMath::Clamp(TimeoutSeconds * 100.0, 10.0, 1000.0))))
+	{
+		//The decoder thread only takes the lock between inputs, so a hung one cannot hold it
+		FScopeLock Lock(&CurrentInputLock);
+		if (CurrentInput == nullptr || FPlatformTime::Seconds() - CurrentInputStartTime < TimeoutSeconds) continue;
+		//Not through SaveArtifact, whose counter belongs to the decoder thread
+		const FString Path = ArtifactsDir / FString::Printf(TEXT("timeout-%s.bin"), GetTargetName(CurrentTarget));
+		FFileHelper::SaveArrayToFile(*CurrentInput, *Path);
+		UE_LOG(LogTemp, Error, TEXT("LeaderboardFuzz: %s input of %d bytes still running after %.0f s, saved %s, replay with -Target=%s -Input=\"%s\""),
+			GetTargetName(CurrentTarget), CurrentInput->Num(), TimeoutSeconds, *Path, GetTargetName(CurrentTarget), *Path);
+		GLog->Flush();
+		FPlatformMisc::RequestExitWithStatus(true, 1);
+	}
+}
+
+bool ULeaderboardFuzzCommandlet::Report() const
+{
+	bool bPassed = true;
+	UE_LOG(LogTemp, Display, TEXT("%-10s %10s %10s %8s %10s %10s"), TEXT("Target"), TEXT("Inputs"), TEXT("Accepted"), TEXT("Failed"), TEXT("Avg us"), TEXT("Max ms"));
+	for (int32 Index = 0; Index < static_cast<int32>(ETarget::Count); ++Index)
+	{
+		const FTargetStats& TargetStats = Stats[Index];
+		if (TargetStats.NumInputs == 0) continue;
+		UE_LOG(LogTemp, Display, TEXT("%-10s %10d %10d %8d %10.1f %10.2f"), GetTargetName(static_cast<ETarget>(Index)),
+			TargetStats.NumInputs, TargetStats.NumAccepted, TargetStats.NumFailed,
+			TargetStats.TotalSeconds * 1000000.0 / TargetStats.NumInputs, TargetStats.MaxSeconds * 1000.0);
+		bPassed &= TargetStats.NumFailed == 0;
+	}
+	UE_LOG(LogTemp, Display, TEXT("LeaderboardFuzz: %s"), bPassed ? TEXT("PASSED") : TEXT("FAILED"));
+	return bPassed;
+}
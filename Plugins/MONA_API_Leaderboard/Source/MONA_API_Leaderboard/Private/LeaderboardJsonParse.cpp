@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardJsonParse.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace LeaderboardJson
+{
+	//Brackets outside of strings, one linear pass
+	static bool IsNestingWithin(FUtf8StringView Content, int32 Limit)
+	{
+		int32 Depth = 0;
+		bool bInString = false;
+		bool bEscaped = false;
+		for (const UTF8CHAR Unit : Content)
+		{
+			const ANSICHAR Char = static_cast<ANSICHAR>(Unit);
+			if (bInString)
+			{
+				if (bEscaped) bEscaped = false;
+				else if (Char == '\\') bEscaped = true;
+				else if (Char == '"') bInString = false;
+				continue;
+			}
+			switch (Char)
+			{
+				case '"': bInString = true; break;
+				case '[':
+				case '{':
+					if (++Depth > Limit) return false;
+					break;
+				case ']':
+				case '}': --Depth; break;
+				default: break;
+			}
+		}
+		return true;
+	}
+
+	static bool IsParseable(FUtf8StringView Content, int32 MaxBytes)
+	{
+		if (Content.Len() > MaxBytes)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Leaderboard: refusing a %d byte response, the limit is %d"), Content.Len(), MaxBytes);
+			return false;
+		}
+		if (!IsNestingWithin(Content, MaxDepth))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Leaderboard: refusing a response nested more than %d levels deep"), MaxDepth);
+			return false;
+		}
+		return true;
+	}
+
+	bool Parse(FUtf8StringView Content, TSharedPtr<FJsonValue>& OutValue, int32 MaxBytes)
+	{
+		OutValue.Reset();
+		if (!IsParseable(Content, MaxBytes)) return false;
+		TSharedRef<TJsonReader<UTF8CHAR>> Reader = TJsonReaderFactory<UTF8CHAR>::CreateFromView(Content);
+		return FJsonSerializer::Deserialize(Reader, OutValue) && OutValue.IsValid();
+	}
+
+	bool Parse(FUtf8StringView Content, TSharedPtr<FJsonObject>& OutObject, int32 MaxBytes)
+	{
+		OutObject.Reset();
+		if (!IsParseable(Content, MaxBytes)) return false;
+		TSharedRef<TJsonReader<UTF8CHAR>> Reader = TJsonReaderFactory<UTF8CHAR>::CreateFromView(Content);
+		return FJsonSerializer::Deserialize(Reader, OutObject) && OutObject.IsValid();
+	}
+}
@@ -0,0 +1,239 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardLoadCommandlet.h"
+#include "LeaderboardController.h"
+#include "LeaderboardSession.h"
+#include "HttpModule.h"
+#include "HttpManager.h"
+#include "Containers/Ticker.h"
+#include "Misc/Parse.h"
+
+ULeaderboardLoadCommandlet::ULeaderboardLoadCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+const TCHAR* ULeaderboardLoadCommandlet::GetOperationName(EOperation Operation)
+{
+	switch (Operation)
+	{
+		case EOperation::GenerateOTP: return TEXT("GenerateOTP");
+		case EOperation::VerifyOTP: return TEXT("VerifyOTP");
+		case EOperation::PostScore: return TEXT("PostScore");
+		case EOperation::TopScores: return TEXT("TopScores");
+		default: return TEXT("Unknown");
+	}
+}
+
+int32 ULeaderboardLoadCommandlet::Main(const FString& Params)
+{
+	int32 NumUsers = 100;
+	float Duration = 60.f;
+	float RampUp = 10.f;
+	FString AppID;
+	FString BaseURL;
+	FString EmailPattern = TEXT("loadtest+{0}@example.com");
+	FParse::Value(*Params, TEXT("Users="), NumUsers);
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("RampUp="), RampUp);
+	FParse::Value(*Params, TEXT("ThinkMin="), ThinkMin);
+	FParse::Value(*Params, TEXT("ThinkMax="), ThinkMax);
+	FParse::Value(*Params, TEXT("ReadRatio="), ReadRatio);
+	FParse::Value(*Params, TEXT("MaxErrorRate="), MaxErrorRate);
+	FParse::Value(*Params, TEXT("AppID="), AppID);
+	FParse::Value(*Params, TEXT("BaseURL="), BaseURL);
+	FParse::Value(*Params, TEXT("Email="), EmailPattern);
+	FParse::Value(*Params, TEXT("OTP="), OTP);
+	FParse::Value(*Params, TEXT("Topic="), Topic);
+	NumUsers = FMath::Max(1, NumUsers);
+	ThinkMax = FMath::Max(ThinkMin, ThinkMax);
+	//One slot per user, so requests go out when the user acts instead of queueing behind other users
+	int32 Concurrency = NumUsers;
+	FParse::Value(*Params, TEXT("Concurrency="), Concurrency);
+
+	ULeaderboardController* Controller = ULeaderboardController::GetLeaderboardController();
+	if (!BaseURL.IsEmpty())
+	{
+		Controller->SetBaseURL(BaseURL);
+	}
+	if (!AppID.IsEmpty())
+	{
+		Controller->SetApplicationID(AppID);
+	}
+	if (!Controller->ValidAppID())
+	{
+		UE_LOG(LogTemp, Error, TEXT("LeaderboardLoad: -AppID=<id> is required"));
+		return 1;
+	}
+	Controller->SetMaxConcurrentRequests(Concurrency);
+	//Random scores would mostly be filtered as non-improving, every post has to reach the server
+	Controller->SetScoreFilter(ELeaderboardScoreFilter::PostAll);
+	Controller->GetScheduler().GetStats().Reset();
+	const FDelegateHandle ObserverHandle = Controller->GetScheduler().OnResponseObserved.AddUObject(this, &ULeaderboardLoadCommandlet::RecordResponse);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double EndTime = StartTime + Duration;
+	Users.SetNum(NumUsers);
+	for (int32 Index = 0; Index < NumUsers; ++Index)
+	{
+		FVirtualUser& User = Users[Index];
+		User.Session = Controller->CreateSession(FString::Printf(TEXT("LoadUser%d"), Index));
+		User.Email = FString::Format(*EmailPattern, {Index});
+		//Spread logins over the ramp-up instead of all at once
+		User.NextActionTime = StartTime + RampUp * Index / NumUsers;
+	}
+	UE_LOG(LogTemp, Display, TEXT("LeaderboardLoad: %d users for %.0f s, %d concurrent requests, against %s%s"), NumUsers, Duration, Concurrency,
+		*Controller->BuildTopScoresURL(FLeaderboardQuery()), Controller->IsReplaying() ? TEXT(" (replay)") : TEXT(""));
+
+	//Event loop. After the duration no new actions start, requests in flight get a grace period to finish
+	constexpr double DrainSeconds = 30.0;
+	double LastTime = StartTime;
+	while (true)
+	{
+		const double Now = FPlatformTime::Seconds();
+		const float DeltaTime = static_cast<float>(Now - LastTime);
+		LastTime = Now;
+		bool bAnyBusy = false;
+		for (int32 Index = 0; Index < Users.Num(); ++Index)
+		{
+			FVirtualUser& User = Users[Index];
+			if (!User.bBusy && Now < EndTime && Now >= User.NextActionTime)
+			{
+				StartNextAction(Index);
+			}
+			bAnyBusy |= User.bBusy;
+		}
+		if ((Now >= EndTime && !bAnyBusy) || Now >= EndTime + DrainSeconds || IsEngineExitRequested()) break;
+		FHttpModule::Get().GetHttpManager().Tick(DeltaTime);
+		FTSTicker::GetCoreTicker().Tick(DeltaTime);
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	//Whatever did not drain in time must not call back into a finished run
+	Controller->GetScheduler().CancelAll();
+	Controller->GetScheduler().OnResponseObserved.Remove(ObserverHandle);
+	const bool bPassed = Report(FPlatformTime::Seconds() - StartTime);
+	Controller->GetScheduler().GetStats().Dump();
+	for (int32 Index = 0; Index < NumUsers; ++Index)
+	{
+		Controller->RemoveSession(FString::Printf(TEXT("LoadUser%d"), Index));
+	}
+	return bPassed ? 0 : 1;
+}
+
+void ULeaderboardLoadCommandlet::StartNextAction(int32 UserIndex)
+{
+	FVirtualUser& User = Users[UserIndex];
+	ULeaderboardSession* Session = User.Session.Get();
+	if (Session == nullptr) return;
+	User.bBusy = true;
+	if (!User.bOtpSent)
+	{
+		Session->GenerateOTPAsync(User.Email, [this, UserIndex](bool bSuccess)
+		{
+			Users[UserIndex].bOtpSent = bSuccess;
+			Finish(UserIndex, EOperation::GenerateOTP, bSuccess);
+		});
+	}
+	else if (!User.bLoggedIn)
+	{
+		Session->VerifyOTPAsync(User.Email, OTP, [this, UserIndex](bool bSuccess)
+		{
+			//A rejected OTP starts the login over
+			Users[UserIndex].bLoggedIn = bSuccess;
+			Users[UserIndex].bOtpSent = bSuccess;
+			Finish(UserIndex, EOperation::VerifyOTP, bSuccess);
+		});
+	}
+	else if (FMath::FRand() < ReadRatio)
+	{
+		FLeaderboardQuery Query;
+		Query.Topic = Topic;
+		ULeaderboardController::GetLeaderboardController()->GetTopScoresAsync(Query, [this, UserIndex](bool bSuccess, const FScores& Scores)
+		{
+			Finish(UserIndex, EOperation::TopScores, bSuccess);
+		});
+	}
+	else
+	{
+		Session->PostScoreAsync(FMath::RandRange(0, 100000), Topic, [this, UserIndex](bool bSuccess)
+		{
+			Finish(UserIndex, EOperation::PostScore, bSuccess);
+		});
+	}
+}
+
+void ULeaderboardLoadCommandlet::Finish(int32 UserIndex, EOperation Operation, bool bSuccess)
+{
+	const double Now = FPlatformTime::Seconds();
+	FOperationStats& OperationStats = Stats[static_cast<int32>(Operation)];
+	OperationStats.NumOperations++;
+	if (!bSuccess)
+	{
+		++OperationStats.NumErrors;
+	}
+	FVirtualUser& User = Users[UserIndex];
+	User.bBusy = false;
+	//Players look at the result before doing the next thing
+	User.NextActionTime = Now + FMath::FRandRange(ThinkMin, ThinkMax);
+}
+
+void ULeaderboardLoadCommandlet::RecordResponse(ELeaderboardEndpoint Endpoint, const FLeaderboardHttpResponse& Response, double QueueSeconds)
+{
+	//Timed from dispatch by the transport, so the client's queue is not part of it
+	FRequestStats& EndpointStats = RequestStats[static_cast<int32>(Endpoint)];
+	EndpointStats.ServerLatencies.Add(Response.Latency);
+	EndpointStats.QueueSeconds.Add(QueueSeconds);
+}
+
+double ULeaderboardLoadCommandlet::GetPercentile(const TArray<double>& Sorted, double Percentile)
+{
+	if (Sorted.Num() == 0) return 0.0;
+	const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+	return Sorted[Index] * 1000.0;
+}
+
+bool ULeaderboardLoadCommandlet::Report(double ElapsedSeconds)
+{
+	int32 TotalOperations = 0;
+	int32 TotalErrors = 0;
+	for (const FOperationStats& OperationStats : Stats)
+	{
+		TotalOperations += OperationStats.NumOperations;
+		TotalErrors += OperationStats.NumErrors;
+	}
+	const double ErrorRate = TotalOperations > 0 ? static_cast<double>(TotalErrors) / TotalOperations : 0.0;
+	UE_LOG(LogTemp, Display, TEXT("LeaderboardLoad: %d operations in %.1f s (%.1f/s), %.2f%% errors"),
+		TotalOperations, ElapsedSeconds, TotalOperations / FMath::Max(ElapsedSeconds, 0.001), ErrorRate * 100.0);
+	UE_LOG(LogTemp, Display, TEXT("  %-12s %8s %8s %8s"), TEXT("Operation"), TEXT("Count"), TEXT("Per s"), TEXT("Errors%"));
+	for (int32 Index = 0; Index < static_cast<int32>(EOperation::Count); ++Index)
+	{
+		const FOperationStats& OperationStats = Stats[Index];
+		if (OperationStats.NumOperations == 0) continue;
+		UE_LOG(LogTemp, Display, TEXT("  %-12s %8d %8.1f %8.2f"), GetOperationName(static_cast<EOperation>(Index)),
+			OperationStats.NumOperations, OperationStats.NumOperations / FMath::Max(ElapsedSeconds, 0.001), 100.0 * OperationStats.NumErrors / OperationStats.NumOperations);
+	}
+	//Server is dispatch to response, Queue the wait for a free slot before dispatch
+	UE_LOG(LogTemp, Display, TEXT("  %-14s %8s %10s %10s %10s %10s %10s %10s %10s"), TEXT("Endpoint"), TEXT("Requests"),
+		TEXT("Server p50"), TEXT("p90"), TEXT("p99"), TEXT("Max"), TEXT("Queue p50"), TEXT("p99"), TEXT("Max"));
+	for (int32 Index = 0; Index < static_cast<int32>(ELeaderboardEndpoint::Count); ++Index)
+	{
+		TArray<double> Latencies = RequestStats[Index].ServerLatencies;
+		TArray<double> Queued = RequestStats[Index].QueueSeconds;
+		if (Latencies.Num() == 0) continue;
+		Latencies.Sort();
+		Queued.Sort();
+		UE_LOG(LogTemp, Display, TEXT("  %-14s %8d %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f"), LexToString(static_cast<ELeaderboardEndpoint>(Index)), Latencies.Num(),
+			GetPercentile(Latencies, 0.5), GetPercentile(Latencies, 0.9), GetPercentile(Latencies, 0.99), Latencies.Last() * 1000.0,
+			GetPercentile(Queued, 0.5), GetPercentile(Queued, 0.99), Queued.Last() * 1000.0);
+	}
+	if (ErrorRate > MaxErrorRate)
+	{
+		UE_LOG(LogTemp, Error, TEXT("LeaderboardLoad: error rate %.2f%% exceeds %.2f%%"), ErrorRate * 100.0, MaxErrorRate * 100.0);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardMemory.h"
+
+ILeaderboardMemoryPool::~ILeaderboardMemoryPool()
+{
+	if (Budget)
+	{
+		Budget->Unregister(*this);
+	}
+}
+
+void ILeaderboardMemoryPool::NotifyGrew()
+{
+	if (Budget)
+	{
+		Budget->Enforce();
+	}
+}
+
+double ILeaderboardMemoryPool::ScoreEntry(int64 Bytes, double RefetchCost, double LastUsedTime)
+{
+	const double IdleSeconds = FMath::Max(0.0, FPlatformTime::Seconds() - LastUsedTime);
+	return static_cast<double>(Bytes) * (1.0 + IdleSeconds) / FMath::Max(RefetchCost, UE_SMALL_NUMBER);
+}
+
+FLeaderboardMemoryBudget::~FLeaderboardMemoryBudget()
+{
+	for (ILeaderboardMemoryPool* Pool : Pools)
+	{
+		Pool->Budget = nullptr;
+	}
+}
+
+void FLeaderboardMemoryBudget::Register(ILeaderboardMemoryPool& Pool)
+{
+	if (Pool.Budget == this) return;
+	if (Pool.Budget)
+	{
+		Pool.Budget->Unregister(Pool);
+	}
+	Pool.Budget = this;
+	Pools.Add(&Pool);
+	Enforce();
+}
+
+void FLeaderboardMemoryBudget::Unregister(ILeaderboardMemoryPool& Pool)
+{
+	if (Pool.Budget != this) return;
+	Pool.Budget = nullptr;
+	Pools.Remove(&Pool);
+}
+
+void FLeaderboardMemoryBudget::SetBudgetBytes(int64 InBudgetBytes)
+{
+	BudgetBytes = FMath::Max<int64>(0, InBudgetBytes);
+	Enforce();
+}
+
+int64 FLeaderboardMemoryBudget::GetUsedBytes() const
+{
+	int64 UsedBytes = 0;
+	for (const ILeaderboardMemoryPool* Pool : Pools)
+	{
+		UsedBytes += Pool->GetUsedBytes();
+	}
+	return UsedBytes;
+}
+
+void FLeaderboardMemoryBudget::Enforce()
+{
+	//Evicting can make a pool report growth again (e.g. a cache rebalancing itself)
+	if (bEnforcing) return;
+	TGuardValue<bool> EnforcingGuard(bEnforcing, true);
+	int64 UsedBytes = GetUsedBytes();
+	while (UsedBytes > BudgetBytes)
+	{
+		ILeaderboardMemoryPool* Victim = nullptr;
+		double VictimScore = -1.0;
+		for (ILeaderboardMemoryPool* Pool : Pools)
+		{
+			double Score = 0.0;
+			if (Pool->GetEvictionCandidate(Score) && Score > VictimScore)
+			{
+				Victim = Pool;
+				VictimScore = Score;
+			}
+		}
+		//Only unevictable memory left (queued request bodies, intern tables in use)
+		if (Victim == nullptr) break;
+		Victim->EvictCandidate();
+		UsedBytes = GetUsedBytes();
+	}
+}
+
+void FLeaderboardMemoryBudget::Dump() const
+{
+	UE_LOG(LogTemp, Display, TEXT("Leaderboard memory: %.1f / %.1f KB"), GetUsedBytes() / 1024.0, BudgetBytes / 1024.0);
+	for (const ILeaderboardMemoryPool* Pool : Pools)
+	{
+		UE_LOG(LogTemp, Display, TEXT("  %-24s %10.1f KB"), Pool->GetPoolName(), Pool->GetUsedBytes() / 1024.0);
+	}
+}
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardPersonalBest.h"
+
+bool FLeaderboardPersonalBests::IsBetter(ELeaderboardSortingOrder Order, double Score, double Than)
+{
+	return Order == ELeaderboardSortingOrder::lowest ? Score < Than : Score > Than;
+}
+
+const FLeaderboardPersonalBests::FBest* FLeaderboardPersonalBests::FindCurrent(const FTopicBests& Bests, ELeaderboardPeriod Period, const FDateTime& Now)
+{
+	const FBest& Best = Bests.Periods[static_cast<int32>(Period)];
+	if (!Best.bKnown || Best.WindowStart != ULeaderboardController::GetPeriodStart(Period, Now)) return nullptr;
+	return &Best;
+}
+
+void FLeaderboardPersonalBests::Offer(FTopicBests& Bests, ELeaderboardPeriod Period, double Score, const FDateTime& Now)
+{
+	FBest& Best = Bests.Periods[static_cast<int32>(Period)];
+	const FDateTime WindowStart = ULeaderboardController::GetPeriodStart(Period, Now);
+	//A best from an earlier window no longer counts
+	if (!Best.bKnown || Best.WindowStart != WindowStart || IsBetter(Bests.Order, Score, Best.Score))
+	{
+		Best.Score = Score;
+		Best.WindowStart = WindowStart;
+		Best.bKnown = true;
+	}
+}
+
+void FLeaderboardPersonalBests::SeedFromBoard(const FLeaderboardQuery& Query, const FScores& Board, const FString& Username, const FDateTime& Now)
+{
+	if (Username.IsEmpty() || !Query.StartTime.IsEmpty() || !Query.EndTime.IsEmpty()) return;
+	FTopicBests& Bests = Topics.FindOrAdd(Query.Topic);
+	//Bests compared the other way round are meaningless now, including those recorded from posts under a wrong guess
+	if (Bests.Order != Query.Order)
+	{
+		const bool bKeepsEveryScore = Bests.bKeepsEveryScore;
+		Bests = FTopicBests();
+		Bests.Order = Query.Order;
+		Bests.bKeepsEveryScore = bKeepsEveryScore;
+	}
+	Bests.bOrderKnown = true;
+	Bests.bKeepsEveryScore |= Query.bIncludeAllUsersScores;
+	//With bIncludeAllUsersScores the player can have several rows, Offer keeps the best
+	for (const FUserInfo& Info : Board.Items)
+	{
+		if (Info.User.Username == Username)
+		{
+			Offer(Bests, Query.Period, Info.Score, Now);
+		}
+	}
+}
+
+void FLeaderboardPersonalBests::RecordPost(const FString& Topic, double Score, const FDateTime& Now)
+{
+	FTopicBests& Bests = Topics.FindOrAdd(Topic);
+	for (int32 Period = 0; Period < NumPeriods; ++Period)
+	{
+		Offer(Bests, static_cast<ELeaderboardPeriod>(Period), Score, Now);
+	}
+}
+
+bool FLeaderboardPersonalBests::WouldImprove(const FString& Topic, double Score, const FDateTime& Now) const
+{
+	const FTopicBests* Bests = Topics.Find(Topic);
+	if (Bests == nullptr || !Bests->bOrderKnown || Bests->bKeepsEveryScore) return true;
+	for (int32 Period = 0; Period < NumPeriods; ++Period)
+	{
+		const FBest* Best = FindCurrent(*Bests, static_cast<ELeaderboardPeriod>(Period), Now);
+		if (Best == nullptr || IsBetter(Bests->Order, Score, Best->Score)) return true;
+	}
+	return false;
+}
+
+bool FLeaderboardPersonalBests::GetBest(const FString& Topic, ELeaderboardPeriod Period, const FDateTime& Now, double& OutScore) const
+{
+	const FTopicBests* Bests = Topics.Find(Topic);
+	if (Bests == nullptr) return false;
+	const FBest* Best = FindCurrent(*Bests, Period, Now);
+	if (Best == nullptr) return false;
+	OutScore = Best->Score;
+	return true;
+}
@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardPlayerComponent.h"
+#include "LeaderboardSession.h"
+#include "Containers/Ticker.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Net/UnrealNetwork.h"
+
+ULeaderboardPlayerComponent::ULeaderboardPlayerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+}
+
+void ULeaderboardPlayerComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME_CONDITION(ULeaderboardPlayerComponent, LastResult, COND_OwnerOnly);
+}
+
+void ULeaderboardPlayerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(UserRetryHandle);
+	UserRetryHandle.Reset();
+	if (ServerSession != nullptr)
+	{
+		ULeaderboardController::GetLeaderboardController()->RemoveSession(ServerPlayerID);
+		ServerSession = nullptr;
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void ULeaderboardPlayerComponent::RegisterWithServer()
+{
+	ULeaderboardSession* Session = ULeaderboardController::GetLeaderboardController()->GetDefaultSession();
+	FString AccessToken, RefreshToken;
+	if (!Session->GetTokens(AccessToken, RefreshToken))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RegisterWithServer: not logged in yet, verify the OTP first"));
+		return;
+	}
+	ServerRegisterTokens(AccessToken, RefreshToken);
+}
+
+void ULeaderboardPlayerComponent::ServerRegisterTokens_Implementation(const FString& AccessToken, const FString& RefreshToken)
+{
+	ULeaderboardController* Controller = ULeaderboardController::GetLeaderboardController();
+	ServerPlayerID = MakePlayerID();
+	ServerSession = Controller->CreateSession(ServerPlayerID);
+	ServerSession->SetTokens(AccessToken, RefreshToken);
+	//Username is what ranks are matched on once scores are in
+	FTSTicker::GetCoreTicker().RemoveTicker(UserRetryHandle);
+	UserRetryHandle.Reset();
+	bUserLookupPending = false;
+	RequestServerUser(0);
+}
+
+void ULeaderboardPlayerComponent::RequestServerUser(int32 Attempt)
+{
+	if (ServerSession == nullptr || bUserLookupPending) return;
+	bUserLookupPending = true;
+	ServerSession->GetUserAsync([WeakThis = TWeakObjectPtr<ULeaderboardPlayerComponent>(this), Session = TWeakObjectPtr<ULeaderboardSession>(ServerSession), Attempt](bool bSuccess, const FUser& User)
+	{
+		ULeaderboardPlayerComponent* Component = WeakThis.Get();
+		//Re-registered since, the new session does its own lookup
+		if (Component == nullptr || Component->ServerSession != Session.Get()) return;
+		Component->bUserLookupPending = false;
+		if (bSuccess && !User.Username.IsEmpty()) return;
+		if (Attempt + 1 >= MaxUserLookupAttempts)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("RegisterWithServer: user lookup for %s failed %d times, ranks stay unknown until a submission retries it"), *Component->ServerPlayerID, MaxUserLookupAttempts);
+			return;
+		}
+		//1, 2, 4... seconds
+		const float Delay = static_cast<float>(1 << Attempt);
+		UE_LOG(LogTemp, Warning, TEXT("RegisterWithServer: user lookup for %s failed, retrying in %.0fs"), *Component->ServerPlayerID, Delay);
+		Component->UserRetryHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(Component, [Component, Attempt](float DeltaTime)
+		{
+			Component->UserRetryHandle.Reset();
+			Component->RequestServerUser(Attempt + 1);
+			return false;
+		}), Delay);
+	});
+}
+
+FString ULeaderboardPlayerComponent::MakePlayerID() const
+{
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	if (PlayerController && PlayerController->PlayerState && PlayerController->PlayerState->GetUniqueId().IsValid())
+	{
+		return PlayerController->PlayerState->GetUniqueId().ToString();
+	}
+	return GetOwner()->GetName();
+}
+
+void ULeaderboardPlayerComponent::SetResult(bool bSuccess, float Score, int32 Rank, bool bSkipped)
+{
+	LastResult.bSuccess = bSuccess;
+	LastResult.bSkipped = bSkipped;
+	LastResult.Score = Score;
+	LastResult.Rank = Rank;
+	LastResult.bRankKnown = Rank != 0;
+	LastResult.Serial++;
+	OnSubmissionResult.Broadcast(LastResult);
+}
+
+void ULeaderboardPlayerComponent::OnRep_LastResult()
+{
+	OnSubmissionResult.Broadcast(LastResult);
+}
+
+void ULeaderboardPlayerComponent::SubmitMatchResults(const TArray<FLeaderboardMatchResult>& Results, const FString& Topic)
+{
+	struct FBatch
+	{
+		//Starts at 1 so posts that fail synchronously cannot finish the batch before every post was issued
+		int32 NumPending = 1;
+		TArray<TPair<TWeakObjectPtr<ULeaderboardPlayerComponent>, float>> Posted;
+		FString Topic;
+	};
+	const TSharedRef<FBatch> Batch = MakeShared<FBatch>();
+	Batch->Topic = Topic;
+
+	//All ranks come from one board fetched after the last post landed
+	auto Finish = [](const TSharedRef<FBatch>& FinishedBatch)
+	{
+		if (--FinishedBatch->NumPending > 0 || FinishedBatch->Posted.Num() == 0) return;
+		FLeaderboardQuery Query;
+		Query.Topic = FinishedBatch->Topic;
+		ULeaderboardController::GetLeaderboardController()->GetTopScoresAsync(Query, [FinishedBatch](bool bSuccess, const FScores& Scores)
+		{
+			if (!bSuccess)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("SubmitMatchResults: scores posted but the board for ranks could not be fetched"));
+			}
+			for (const TPair<TWeakObjectPtr<ULeaderboardPlayerComponent>, float>& Posted : FinishedBatch->Posted)
+			{
+				ULeaderboardPlayerComponent* Component = Posted.Key.Get();
+				if (Component == nullptr || Component->ServerSession == nullptr) continue;
+				//The posts themselves succeeded either way, only the rank is unknown without a board
+				if (!bSuccess)
+				{
+					Component->SetResult(true, Posted.Value, 0);
+					continue;
+				}
+				//Without a username there is nothing to match, which says nothing about whether the player made the board
+				const FString& Username = Component->ServerSession->CurrentUser.Username;
+				if (Username.IsEmpty())
+				{
+					UE_LOG(LogTemp, Warning, TEXT("SubmitMatchResults: %s has no known username, rank unknown"), *Component->ServerPlayerID);
+					Component->SetResult(true, Posted.Value, 0);
+					if (!Component->UserRetryHandle.IsValid())
+					{
+						Component->RequestServerUser(0);
+					}
+					continue;
+				}
+				const FUserInfo* Row = Scores.Items.FindByPredicate([&Username](const FUserInfo& Info) { return Info.User.Username == Username; });
+				Component->SetResult(true, Posted.Value, Row ? Row->Rank : INDEX_NONE);
+			}
+		});
+	};
+
+	//Every post goes to the scheduler at once, it keeps MaxConcurrentRequests of them in flight
+	for (const FLeaderboardMatchResult& Result : Results)
+	{
+		ULeaderboardPlayerComponent* Component = Result.Player ? Result.Player->FindComponentByClass<ULeaderboardPlayerComponent>() : nullptr;
+		if (Component == nullptr) continue;
+		if (Component->ServerSession == nullptr)
+		{
+			Component->SetResult(false, Result.Score, 0);
+			continue;
+		}
+		Batch->NumPending++;
+		Component->ServerSession->PostScoreAsync(Result.Score, Topic, FOnScorePostComplete([Batch, Finish, WeakComponent = TWeakObjectPtr<ULeaderboardPlayerComponent>(Component), Score = Result.Score](ELeaderboardPostResult PostResult)
+		{
+			if (PostResult == ELeaderboardPostResult::Posted)
+			{
+				Batch->Posted.Emplace(WeakComponent, Score);
+			}
+			else if (ULeaderboardPlayerComponent* FailedComponent = WeakComponent.Get())
+			{
+				FailedComponent->SetResult(false, Score, 0, PostResult == ELeaderboardPostResult::Skipped);
+			}
+			Finish(Batch);
+		}));
+	}
+	Finish(Batch);
+}
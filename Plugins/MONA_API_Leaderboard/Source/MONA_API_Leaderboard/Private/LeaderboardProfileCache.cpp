@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardProfileCache.h"
+
+int64 FLeaderboardProfileCache::GetEntryBytes(const FString& Key, const FLeaderboardProfile& Profile)
+{
+	//Key is stored twice, in the map and in the recency list
+	return sizeof(FEntry) + sizeof(FRecencyList::TDoubleLinkedListNode) + 2 * Key.GetAllocatedSize()
+		+ Profile.Username.GetAllocatedSize() + Profile.Name.GetAllocatedSize() + Profile.Avatar_Url.GetAllocatedSize();
+}
+
+const FLeaderboardProfile* FLeaderboardProfileCache::Find(const FString& Username)
+{
+	FEntry* Entry = Entries.Find(Username);
+	if (Entry == nullptr)
+	{
+		NumMisses++;
+		return nullptr;
+	}
+	NumHits++;
+	Entry->LastUsedTime = FPlatformTime::Seconds();
+	if (Entry->Node != Recency.GetHead())
+	{
+		Recency.RemoveNode(Entry->Node, false);
+		Recency.AddHead(Entry->Node);
+	}
+	return &Entry->Profile;
+}
+
+void FLeaderboardProfileCache::Store(const FLeaderboardProfile& Profile)
+{
+	if (Profile.Username.IsEmpty()) return;
+	Remove(Profile.Username);
+	FEntry& Entry = Entries.Add(Profile.Username);
+	Entry.Profile = Profile;
+	Recency.AddHead(Profile.Username);
+	Entry.Node = Recency.GetHead();
+	Entry.Bytes = GetEntryBytes(Profile.Username, Profile);
+	Entry.LastUsedTime = FPlatformTime::Seconds();
+	UsedBytes += Entry.Bytes;
+	EvictToBudget();
+	NotifyGrew();
+}
+
+void FLeaderboardProfileCache::Remove(const FString& Username)
+{
+	FEntry Entry;
+	if (Entries.RemoveAndCopyValue(Username, Entry))
+	{
+		Recency.RemoveNode(Entry.Node);
+		UsedBytes -= Entry.Bytes;
+	}
+}
+
+void FLeaderboardProfileCache::Empty()
+{
+	Entries.Empty();
+	Recency.Empty();
+	UsedBytes = 0;
+}
+
+void FLeaderboardProfileCache::SetBudgetBytes(int64 InBudgetBytes)
+{
+	BudgetBytes = FMath::Max<int64>(0, InBudgetBytes);
+	EvictToBudget();
+}
+
+void FLeaderboardProfileCache::EvictToBudget()
+{
+	while (UsedBytes > BudgetBytes && Recency.GetTail() != nullptr)
+	{
+		//Copy, removing the entry frees the node holding the key
+		const FString Username = Recency.GetTail()->GetValue();
+		Remove(Username);
+	}
+}
+
+bool FLeaderboardProfileCache::GetEvictionCandidate(double& OutScore) const
+{
+	//Within this cache recency decides, the least recently used profile is the one on offer
+	const FRecencyList::TDoubleLinkedListNode* Tail = Recency.GetTail();
+	if (Tail == nullptr) return false;
+	const FEntry& Entry = Entries.FindChecked(Tail->GetValue());
+	OutScore = ScoreEntry(Entry.Bytes, RefetchCost, Entry.LastUsedTime);
+	return true;
+}
+
+void FLeaderboardProfileCache::EvictCandidate()
+{
+	if (const FRecencyList::TDoubleLinkedListNode* Tail = Recency.GetTail())
+	{
+		const FString Username = Tail->GetValue();
+		Remove(Username);
+	}
+}
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+/**
+ * Promise that is always fulfilled. If the callback holding it is dropped without running
+ * (e.g. the request was cancelled) it resolves to FailedValue instead of leaving the future broken.
+ */
+template<typename ResultType>
+class TLeaderboardPromise
+{
+public:
+	explicit TLeaderboardPromise(ResultType InFailedValue = ResultType())
+		: FailedValue(MoveTemp(InFailedValue))
+	{
+	}
+
+	~TLeaderboardPromise()
+	{
+		if (!bIsSet)
+		{
+			Promise.SetValue(MoveTemp(FailedValue));
+		}
+	}
+
+	TFuture<ResultType> GetFuture() { return Promise.GetFuture(); }
+
+	void SetValue(ResultType Value)
+	{
+		if (bIsSet) return;
+		bIsSet = true;
+		Promise.SetValue(MoveTemp(Value));
+	}
+
+private:
+	TPromise<ResultType> Promise;
+	ResultType FailedValue;
+	bool bIsSet = false;
+};
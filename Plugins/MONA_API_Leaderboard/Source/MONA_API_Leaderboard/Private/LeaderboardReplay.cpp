@@ -0,0 +1,275 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardReplay.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace LeaderboardReplay
+{
+	static constexpr uint32 FileMagic = 0x4D4C4252; //"MLBR"
+	static constexpr uint32 FileVersion = 1;
+	//Refuse to inflate anything bigger, a corrupt header must not allocate gigabytes
+	static constexpr int64 MaxUncompressedSize = 256 * 1024 * 1024;
+
+	static const TCHAR* RedactedValue = TEXT("redacted");
+
+	static bool IsSecretHeader(const FString& Name)
+	{
+		return Name.Equals(TEXT("Authorization"), ESearchCase::IgnoreCase)
+			|| Name.Equals(TEXT("Cookie"), ESearchCase::IgnoreCase)
+			|| Name.Equals(TEXT("Set-Cookie"), ESearchCase::IgnoreCase);
+	}
+
+	static bool IsSecretField(const FString& Name)
+	{
+		return Name == TEXT("access") || Name == TEXT("refresh") || Name == TEXT("otp")
+			|| Name == TEXT("signature") || Name == TEXT("email");
+	}
+
+	static bool RedactObject(const TSharedPtr<FJsonObject>& Object)
+	{
+		bool bRedacted = false;
+		for (TPair<FString, TSharedPtr<FJsonValue>>& Field : Object->Values)
+		{
+			if (!Field.Value.IsValid()) continue;
+			if (Field.Value->Type == EJson::String && IsSecretField(Field.Key))
+			{
+				Field.Value = MakeShared<FJsonValueString>(RedactedValue);
+				bRedacted = true;
+			}
+			else if (Field.Value->Type == EJson::Object)
+			{
+				bRedacted |= RedactObject(Field.Value->AsObject());
+			}
+		}
+		return bRedacted;
+	}
+}
+
+FArchive& operator<<(FArchive& Ar, FLeaderboardRecordedExchange& Exchange)
+{
+	Ar << Exchange.Verb;
+	Ar << Exchange.URL;
+	Ar << Exchange.RequestHeaders;
+	Ar << Exchange.RequestBody;
+	Ar << Exchange.Code;
+	Ar << Exchange.ResponseHeaders;
+	Ar << Exchange.ResponseBody;
+	Ar << Exchange.StartOffset;
+	Ar << Exchange.Duration;
+	return Ar;
+}
+
+bool FLeaderboardRecording::SaveToFile(const FString& Path) const
+{
+	TArray<uint8> Raw;
+	FMemoryWriter RawWriter(Raw);
+	int32 NumExchanges = Exchanges.Num();
+	RawWriter << NumExchanges;
+	for (const FLeaderboardRecordedExchange& Exchange : Exchanges)
+	{
+		RawWriter << const_cast<FLeaderboardRecordedExchange&>(Exchange);
+	}
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Raw.Num());
+	TArray<uint8> Compressed;
+	Compressed.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Raw.GetData(), Raw.Num()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Leaderboard recording: compression failed"));
+		return false;
+	}
+	Compressed.SetNum(CompressedSize, false);
+
+	TArray<uint8> File;
+	FMemoryWriter FileWriter(File);
+	uint32 Magic = LeaderboardReplay::FileMagic;
+	uint32 Version = LeaderboardReplay::FileVersion;
+	int64 UncompressedSize = Raw.Num();
+	FileWriter << Magic << Version << UncompressedSize;
+	File.Append(Compressed);
+	return FFileHelper::SaveArrayToFile(File, *Path);
+}
+
+bool FLeaderboardRecording::LoadFromFile(const FString& Path)
+{
+	TArray<uint8> File;
+	if (!FFileHelper::LoadFileToArray(File, *Path))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Leaderboard recording: cannot read %s"), *Path);
+		return false;
+	}
+	FMemoryReader FileReader(File);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int64 UncompressedSize = 0;
+	FileReader << Magic << Version << UncompressedSize;
+	if (FileReader.IsError() || Magic != LeaderboardReplay::FileMagic || Version != LeaderboardReplay::FileVersion
+		|| UncompressedSize < 0 || UncompressedSize > LeaderboardReplay::MaxUncompressedSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Leaderboard recording: %s is not a recording this version can read"), *Path);
+		return false;
+	}
+
+	const int64 HeaderSize = FileReader.Tell();
+	TArray<uint8> Raw;
+	Raw.SetNumUninitialized(static_cast<int32>(UncompressedSize));
+	if (!FCompression::UncompressMemory(NAME_Zlib, Raw.GetData(), Raw.Num(), File.GetData() + HeaderSize, File.Num() - HeaderSize))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Leaderboard recording: %s is corrupt"), *Path);
+		return false;
+	}
+
+	FMemoryReader RawReader(Raw);
+	int32 NumExchanges = 0;
+	RawReader << NumExchanges;
+	TArray<FLeaderboardRecordedExchange> Loaded;
+	for (int32 Index = 0; Index < NumExchanges && !RawReader.IsError() && !RawReader.AtEnd(); ++Index)
+	{
+		RawReader << Loaded.AddDefaulted_GetRef();
+	}
+	if (RawReader.IsError() || Loaded.Num() != NumExchanges)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Leaderboard recording: %s is truncated"), *Path);
+		return false;
+	}
+	Exchanges = MoveTemp(Loaded);
+	return true;
+}
+
+void FLeaderboardRecording::RedactHeaders(TArray<FString>& Headers)
+{
+	for (FString& Header : Headers)
+	{
+		FString Name, Value;
+		if (Header.Split(TEXT(":"), &Name, &Value) && LeaderboardReplay::IsSecretHeader(Name.TrimStartAndEnd()))
+		{
+			Header = Name + TEXT(": ") + LeaderboardReplay::RedactedValue;
+		}
+	}
+}
+
+void FLeaderboardRecording::RedactBody(TArray<uint8>& Body)
+{
+	if (Body.Num() == 0) return;
+	TSharedPtr<FJsonObject> Object;
+	TSharedRef<TJsonReader<UTF8CHAR>> Reader = TJsonReaderFactory<UTF8CHAR>::CreateFromView(FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Body.GetData()), Body.Num()));
+	//Not a JSON object, nothing we know how to redact
+	if (!FJsonSerializer::Deserialize(Reader, Object) || !Object.IsValid()) return;
+	if (!LeaderboardReplay::RedactObject(Object)) return;
+
+	FString Redacted;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Redacted);
+	FJsonSerializer::Serialize(Object.ToSharedRef(), Writer);
+	FTCHARToUTF8 Utf8(*Redacted, Redacted.Len());
+	Body.Reset();
+	Body.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+}
+
+FLeaderboardRecordingTransport::FLeaderboardRecordingTransport(const TSharedRef<ILeaderboardTransport>& InInner)
+	: Inner(InInner)
+	, Recording(MakeShared<FLeaderboardRecording>())
+	, RecordingStartTime(FPlatformTime::Seconds())
+{
+}
+
+void FLeaderboardRecordingTransport::Send(const FHttpRequestRef& Request, TFunction<void(const FLeaderboardHttpResponse&)>&& OnComplete)
+{
+	FLeaderboardRecordedExchange Exchange;
+	Exchange.Verb = Request->GetVerb();
+	Exchange.URL = Request->GetURL();
+	Exchange.RequestHeaders = Request->GetAllHeaders();
+	Exchange.RequestBody = Request->GetContent();
+	Exchange.StartOffset = FPlatformTime::Seconds() - RecordingStartTime;
+	FLeaderboardRecording::RedactHeaders(Exchange.RequestHeaders);
+	FLeaderboardRecording::RedactBody(Exchange.RequestBody);
+
+	//The recording outlives this transport if the controller swaps it out mid-flight
+	Inner->Send(Request, [Recording = Recording, Exchange = MoveTemp(Exchange), OnComplete = MoveTemp(OnComplete)](const FLeaderboardHttpResponse& Response) mutable
+	{
+		Exchange.Code = Response.Code;
+		Exchange.Duration = Response.Latency;
+		Exchange.ResponseHeaders = Response.GetAllHeaders();
+		const TArrayView<const uint8> Content = Response.GetContent();
+		Exchange.ResponseBody = TArray<uint8>(Content.GetData(), Content.Num());
+		FLeaderboardRecording::RedactHeaders(Exchange.ResponseHeaders);
+		FLeaderboardRecording::RedactBody(Exchange.ResponseBody);
+		Recording->Exchanges.Add(MoveTemp(Exchange));
+		OnComplete(Response);
+	});
+}
+
+void FLeaderboardRecordingTransport::Cancel(const FHttpRequestRef& Request)
+{
+	Inner->Cancel(Request);
+}
+
+FLeaderboardReplayTransport::FLeaderboardReplayTransport(const FLeaderboardRecording& Recording, float InSpeed)
+	: Speed(InSpeed)
+{
+	for (const FLeaderboardRecordedExchange& Exchange : Recording.Exchanges)
+	{
+		Queues.FindOrAdd(MakeKey(Exchange.Verb, Exchange.URL)).Exchanges.Add(Exchange);
+	}
+}
+
+FLeaderboardReplayTransport::~FLeaderboardReplayTransport()
+{
+	for (const TPair<const IHttpRequest*, FTSTicker::FDelegateHandle>& Pair : Pending)
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(Pair.Value);
+	}
+}
+
+FString FLeaderboardReplayTransport::MakeKey(const FString& Verb, const FString& URL)
+{
+	return Verb + TEXT(' ') + URL;
+}
+
+void FLeaderboardReplayTransport::Send(const FHttpRequestRef& Request, TFunction<void(const FLeaderboardHttpResponse&)>&& OnComplete)
+{
+	FLeaderboardHttpResponse Response;
+	Response.URL = Request->GetURL();
+	double Delay = 0.0;
+	if (FExchangeQueue* Queue = Queues.Find(MakeKey(Request->GetVerb(), Request->GetURL())))
+	{
+		const FLeaderboardRecordedExchange& Exchange = Queue->Exchanges[FMath::Min(Queue->Next, Queue->Exchanges.Num() - 1)];
+		Queue->Next++;
+		TArray<FString> Headers = Exchange.ResponseHeaders;
+		TArray<uint8> Content = Exchange.ResponseBody;
+		Response = FLeaderboardHttpResponse::FromData(Response.URL, Exchange.Code, MoveTemp(Headers), MoveTemp(Content));
+		Response.Latency = Exchange.Duration;
+		Delay = Speed > 0.f ? Exchange.Duration / Speed : 0.0;
+	}
+	else
+	{
+		NumUnmatched++;
+		UE_LOG(LogTemp, Warning, TEXT("Leaderboard replay: no recorded response for %s %s"), *Request->GetVerb(), *Request->GetURL());
+	}
+
+	//Always complete from the ticker, callers never expect a response from inside Send
+	const IHttpRequest* Key = &Request.Get();
+	TWeakPtr<FLeaderboardReplayTransport> WeakThis = AsShared();
+	Pending.Add(Key, FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+		[WeakThis, Key, Response = MoveTemp(Response), OnComplete = MoveTemp(OnComplete)](float DeltaTime)
+		{
+			if (TSharedPtr<FLeaderboardReplayTransport> This = WeakThis.Pin())
+			{
+				This->Pending.Remove(Key);
+			}
+			OnComplete(Response);
+			return false;
+		}), static_cast<float>(Delay)));
+}
+
+void FLeaderboardReplayTransport::Cancel(const FHttpRequestRef& Request)
+{
+	FTSTicker::FDelegateHandle Handle;
+	if (Pending.RemoveAndCopyValue(&Request.Get(), Handle))
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(Handle);
+	}
+}
@@ -0,0 +1,226 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardReplicator.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "TimerManager.h"
+#include "Net/UnrealNetwork.h"
+
+void FLeaderboardReplicatedBoard::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	//One rebuild per received update, however many rows it touched
+	if (Owner)
+	{
+		Owner->RebuildBoard();
+	}
+}
+
+int64 FLeaderboardNameTablePool::GetUsedBytes() const
+{
+	if (Owner == nullptr) return 0;
+	int64 Bytes = Owner->Names.GetAllocatedSize() + Owner->NameIndices.GetAllocatedSize();
+	for (const FString& Name : Owner->Names)
+	{
+		//Once in the table, once as a map key
+		Bytes += 2 * Name.GetAllocatedSize();
+	}
+	return Bytes;
+}
+
+ALeaderboardReplicator::ALeaderboardReplicator()
+{
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	//Boards change on the order of seconds
+	NetUpdateFrequency = 2.f;
+}
+
+void ALeaderboardReplicator::PostInitProperties()
+{
+	Super::PostInitProperties();
+	ReplicatedBoard.Owner = this;
+	NameTablePool.Owner = this;
+}
+
+void ALeaderboardReplicator::BeginPlay()
+{
+	Super::BeginPlay();
+	ULeaderboardController::GetLeaderboardController()->GetMemoryBudget().Register(NameTablePool);
+}
+
+void ALeaderboardReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(ALeaderboardReplicator, Names);
+	DOREPLIFETIME(ALeaderboardReplicator, ReplicatedBoard);
+}
+
+void ALeaderboardReplicator::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopServerBoard();
+	ULeaderboardController::GetLeaderboardController()->GetMemoryBudget().Unregister(NameTablePool);
+	Super::EndPlay(EndPlayReason);
+}
+
+ALeaderboardReplicator* ALeaderboardReplicator::FindReplicator(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (World == nullptr) return nullptr;
+	TActorIterator<ALeaderboardReplicator> It(World);
+	return It ? *It : nullptr;
+}
+
+void ALeaderboardReplicator::StartServerBoard(const FLeaderboardQuery& Query, float RefreshInterval)
+{
+	if (!HasAuthority()) return;
+	StopServerBoard();
+	ServerQuery = Query;
+	GetWorldTimerManager().SetTimer(RefreshTimer, this, &ALeaderboardReplicator::FetchServerBoard, FMath::Max(1.f, RefreshInterval), true, 0.f);
+}
+
+void ALeaderboardReplicator::StopServerBoard()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(RefreshTimer);
+	}
+	ULeaderboardController::GetLeaderboardController()->CancelRequest(FetchHandle);
+	FetchHandle.Invalidate();
+	bFetchInFlight = false;
+}
+
+void ALeaderboardReplicator::FetchServerBoard()
+{
+	//Previous fetch still out, the board cannot be newer than what it will bring
+	if (bFetchInFlight) return;
+	bFetchInFlight = true;
+	TWeakObjectPtr<ALeaderboardReplicator> WeakThis(this);
+	FetchHandle = ULeaderboardController::GetLeaderboardController()->GetTopScoresAsync(ServerQuery, [WeakThis](bool bSuccess, const FScores& Scores)
+	{
+		ALeaderboardReplicator* This = WeakThis.Get();
+		if (This == nullptr) return;
+		This->bFetchInFlight = false;
+		This->FetchHandle.Invalidate();
+		if (bSuccess)
+		{
+			This->SetBoard(Scores);
+		}
+	});
+}
+
+uint16 ALeaderboardReplicator::InternName(const FString& Name)
+{
+	if (const uint16* Index = NameIndices.Find(Name))
+	{
+		return *Index;
+	}
+	const uint16 Index = static_cast<uint16>(Names.Add(Name));
+	NameIndices.Add(Name, Index);
+	return Index;
+}
+
+void ALeaderboardReplicator::CompactNames()
+{
+	//Row indices change with it, the diff in SetBoard then resends every row once
+	Names.Reset();
+	NameIndices.Reset();
+}
+
+void ALeaderboardReplicator::SetBoard(const FScores& InBoard)
+{
+	if (!HasAuthority()) return;
+	Board = InBoard;
+	Board.Items.Sort([](const FUserInfo& A, const FUserInfo& B) { return A.Rank < B.Rank; });
+
+	//Names of players who left the board pile up, start over once they dominate the table
+	if (Names.Num() + 2 * Board.Items.Num() > MAX_uint16 || Names.Num() > 4 * Board.Items.Num() + 64)
+	{
+		CompactNames();
+	}
+
+	TMap<int32, const FUserInfo*> Incoming;
+	Incoming.Reserve(Board.Items.Num());
+	for (const FUserInfo& Info : Board.Items)
+	{
+		Incoming.Add(Info.ID, &Info);
+	}
+
+	bool bChanged = false;
+	bool bRemoved = false;
+	for (int32 Index = ReplicatedBoard.Rows.Num() - 1; Index >= 0; --Index)
+	{
+		FLeaderboardReplicatedRow& Row = ReplicatedBoard.Rows[Index];
+		const FUserInfo* Info = nullptr;
+		if (!Incoming.RemoveAndCopyValue(Row.ID, Info))
+		{
+			ReplicatedBoard.Rows.RemoveAtSwap(Index, 1, false);
+			bRemoved = true;
+			continue;
+		}
+		const uint16 UsernameIndex = InternName(Info->User.Username);
+		const uint16 NameIndex = InternName(Info->User.Name);
+		if (Row.Rank != Info->Rank || Row.Score != Info->Score || Row.UsernameIndex != UsernameIndex || Row.NameIndex != NameIndex)
+		{
+			Row.Rank = Info->Rank;
+			Row.Score = Info->Score;
+			Row.UsernameIndex = UsernameIndex;
+			Row.NameIndex = NameIndex;
+			ReplicatedBoard.MarkItemDirty(Row);
+			bChanged = true;
+		}
+	}
+	for (const TPair<int32, const FUserInfo*>& Pair : Incoming)
+	{
+		FLeaderboardReplicatedRow& Row = ReplicatedBoard.Rows.AddDefaulted_GetRef();
+		Row.ID = Pair.Key;
+		Row.Rank = Pair.Value->Rank;
+		Row.Score = Pair.Value->Score;
+		Row.UsernameIndex = InternName(Pair.Value->User.Username);
+		Row.NameIndex = InternName(Pair.Value->User.Name);
+		ReplicatedBoard.MarkItemDirty(Row);
+		bChanged = true;
+	}
+	if (bRemoved)
+	{
+		ReplicatedBoard.MarkArrayDirty();
+	}
+	if (bChanged || bRemoved)
+	{
+		OnBoardChanged.Broadcast(Board);
+	}
+}
+
+void ALeaderboardReplicator::OnRep_Names()
+{
+	//New names only matter if rows already refer to them, or the table was compacted under existing rows
+	if (bAwaitingNames || Names.Num() < NumNamesSeen)
+	{
+		RebuildBoard();
+	}
+	NumNamesSeen = Names.Num();
+}
+
+void ALeaderboardReplicator::RebuildBoard()
+{
+	bAwaitingNames = false;
+	FScores NewBoard;
+	NewBoard.Items.Reserve(ReplicatedBoard.Rows.Num());
+	for (const FLeaderboardReplicatedRow& Row : ReplicatedBoard.Rows)
+	{
+		if (!Names.IsValidIndex(Row.UsernameIndex) || !Names.IsValidIndex(Row.NameIndex))
+		{
+			bAwaitingNames = true;
+			return;
+		}
+		FUserInfo& Info = NewBoard.Items.AddDefaulted_GetRef();
+		Info.ID = Row.ID;
+		Info.Rank = Row.Rank;
+		Info.Score = Row.Score;
+		Info.User.Username = Names[Row.UsernameIndex];
+		Info.User.Name = Names[Row.NameIndex];
+	}
+	NewBoard.Items.Sort([](const FUserInfo& A, const FUserInfo& B) { return A.Rank < B.Rank; });
+	NewBoard.Count = NewBoard.Items.Num();
+	Board = MoveTemp(NewBoard);
+	OnBoardChanged.Broadcast(Board);
+}
@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardRequestScheduler.h"
+#include "LeaderboardAllocationCounter.h"
+
+FLeaderboardRequestScheduler::FLeaderboardRequestScheduler()
+	: Transport(MakeShared<FLeaderboardHttpTransport>())
+{
+}
+
+FLeaderboardRequestScheduler::~FLeaderboardRequestScheduler()
+{
+	CancelAll();
+}
+
+FLeaderboardRequestHandle FLeaderboardRequestScheduler::Submit(const FHttpRequestRef& Request, ELeaderboardEndpoint Endpoint, ELeaderboardRequestPriority Priority, FLeaderboardResponseDelegate OnComplete)
+{
+	check(IsInGameThread());
+	FScheduledRequest Scheduled;
+	Scheduled.ID = NextID++;
+	Scheduled.Endpoint = Endpoint;
+	Scheduled.Request = Request;
+	Scheduled.OnComplete = MoveTemp(OnComplete);
+	Scheduled.SubmitTime = FPlatformTime::Seconds();
+
+	FLeaderboardRequestHandle Handle;
+	Handle.ID = Scheduled.ID;
+	Queues[static_cast<int32>(Priority)].Add(MoveTemp(Scheduled));
+	Pump();
+	NotifyGrew();
+	return Handle;
+}
+
+bool FLeaderboardRequestScheduler::Cancel(FLeaderboardRequestHandle Handle)
+{
+	check(IsInGameThread());
+	if (!Handle.IsValid()) return false;
+	//Still queued, drop it before it ever hits the network
+	for (TArray<FScheduledRequest>& Queue : Queues)
+	{
+		const int32 Index = Queue.IndexOfByPredicate([&Handle](const FScheduledRequest& Scheduled) { return Scheduled.ID == Handle.ID; });
+		if (Index != INDEX_NONE)
+		{
+			Queue.RemoveAt(Index);
+			return true;
+		}
+	}
+	//In flight, forget it first so the completion callback is ignored
+	FScheduledRequest Scheduled;
+	if (InFlight.RemoveAndCopyValue(Handle.ID, Scheduled))
+	{
+		Scheduled.Transport->Cancel(Scheduled.Request.ToSharedRef());
+		Pump();
+		return true;
+	}
+	return false;
+}
+
+void FLeaderboardRequestScheduler::CancelAll()
+{
+	for (TArray<FScheduledRequest>& Queue : Queues)
+	{
+		Queue.Empty();
+	}
+	TMap<uint64, FScheduledRequest> Cancelled = MoveTemp(InFlight);
+	InFlight.Reset();
+	for (TPair<uint64, FScheduledRequest>& Pair : Cancelled)
+	{
+		Pair.Value.Transport->Cancel(Pair.Value.Request.ToSharedRef());
+	}
+}
+
+void FLeaderboardRequestScheduler::SetMaxConcurrentRequests(int32 InMaxConcurrentRequests)
+{
+	MaxConcurrentRequests = FMath::Max(1, InMaxConcurrentRequests);
+	Pump();
+}
+
+int32 FLeaderboardRequestScheduler::GetNumQueued() const
+{
+	int32 NumQueued = 0;
+	for (const TArray<FScheduledRequest>& Queue : Queues)
+	{
+		NumQueued += Queue.Num();
+	}
+	return NumQueued;
+}
+
+int64 FLeaderboardRequestScheduler::GetUsedBytes() const
+{
+	int64 Bytes = 0;
+	for (const TArray<FScheduledRequest>& Queue : Queues)
+	{
+		for (const FScheduledRequest& Scheduled : Queue)
+		{
+			Bytes += Scheduled.Request->GetContentLength();
+		}
+	}
+	for (const TPair<uint64, FScheduledRequest>& Pair : InFlight)
+	{
+		Bytes += Pair.Value.Request->GetContentLength();
+	}
+	return Bytes;
+}
+
+void FLeaderboardRequestScheduler::Pump()
+{
+	for (TArray<FScheduledRequest>& Queue : Queues)
+	{
+		while (InFlight.Num() < MaxConcurrentRequests && Queue.Num() > 0)
+		{
+			FScheduledRequest Scheduled = MoveTemp(Queue[0]);
+			Queue.RemoveAt(0, 1, false);
+			Dispatch(MoveTemp(Scheduled));
+		}
+	}
+}
+
+void FLeaderboardRequestScheduler::Dispatch(FScheduledRequest&& Scheduled)
+{
+	const FHttpRequestRef Request = Scheduled.Request.ToSharedRef();
+	const uint64 ID = Scheduled.ID;
+	//Cancellation has to reach the transport the request actually went out on
+	Scheduled.Transport = Transport;
+	Scheduled.QueueSeconds = FPlatformTime::Seconds() - Scheduled.SubmitTime;
+	const TSharedRef<ILeaderboardTransport> DispatchTransport = Transport;
+	Stats.RecordRequest(Scheduled.Endpoint);
+	InFlight.Add(ID, MoveTemp(Scheduled));
+	DispatchTransport->Send(Request, [this, ID](const FLeaderboardHttpResponse& Response)
+	{
+		HandleRequestComplete(Response, ID);
+	});
+}
+
+void FLeaderboardRequestScheduler::HandleRequestComplete(const FLeaderboardHttpResponse& Response, uint64 ID)
+{
+	FScheduledRequest Scheduled;
+	//Cancelled requests were already removed, their response is never handed on
+	if (!InFlight.RemoveAndCopyValue(ID, Scheduled)) return;
+	OnResponseObserved.Broadcast(Scheduled.Endpoint, Response, Scheduled.QueueSeconds);
+	const FLeaderboardAllocationCounter::FScope HandlerAllocations;
+	const double HandlerStartTime = FPlatformTime::Seconds();
+	Scheduled.OnComplete.ExecuteIfBound(Response);
+	Stats.RecordResponse(Scheduled.Endpoint, Response, FPlatformTime::Seconds() - HandlerStartTime, HandlerAllocations.GetAllocatedBytes());
+	Pump();
+}
@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardRequestTemplates.h"
+#include "HttpModule.h"
+#include "Misc/StringBuilder.h"
+
+const TCHAR* LexToString(ELeaderboardEndpoint Endpoint)
+{
+	switch (Endpoint)
+	{
+		case ELeaderboardEndpoint::GenerateOTP: return TEXT("GenerateOTP");
+		case ELeaderboardEndpoint::VerifyOTP: return TEXT("VerifyOTP");
+		case ELeaderboardEndpoint::RefreshToken: return TEXT("RefreshToken");
+		case ELeaderboardEndpoint::PostScore: return TEXT("PostScore");
+		case ELeaderboardEndpoint::GetUser: return TEXT("GetUser");
+		case ELeaderboardEndpoint::TopScores: return TEXT("TopScores");
+		case ELeaderboardEndpoint::Profiles: return TEXT("Profiles");
+		case ELeaderboardEndpoint::TopScoresBatch: return TEXT("TopScoresBatch");
+		default: return TEXT("Unknown");
+	}
+}
+
+bool LexTryParseString(ELeaderboardEndpoint& OutEndpoint, const TCHAR* Name)
+{
+	for (int32 Index = 0; Index < static_cast<int32>(ELeaderboardEndpoint::Count); ++Index)
+	{
+		if (FCString::Stricmp(Name, LexToString(static_cast<ELeaderboardEndpoint>(Index))) == 0)
+		{
+			OutEndpoint = static_cast<ELeaderboardEndpoint>(Index);
+			return true;
+		}
+	}
+	return false;
+}
+
+FHttpRequestRef FLeaderboardRequestTemplate::Instantiate() const
+{
+	FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+	Request->SetVerb(Verb);
+	Request->SetURL(URL);
+	for (const TPair<FString, FString>& Header : Headers)
+	{
+		Request->SetHeader(Header.Key, Header.Value);
+	}
+	return Request;
+}
+
+void FLeaderboardRequestTemplates::Rebuild(const FString& BaseURL, const FString& ApplicationID, const FString& ProfilesPath, const FString& TopScoresBatchPath)
+{
+	auto Make = [&](ELeaderboardEndpoint Endpoint, const TCHAR* Verb, FString URL, bool bJsonBody)
+	{
+		FLeaderboardRequestTemplate& Template = Templates[static_cast<int32>(Endpoint)];
+		Template.Verb = Verb;
+		Template.URL = MoveTemp(URL);
+		Template.Headers.Reset();
+		Template.Headers.Emplace(TEXT("X-Mona-Application-Id"), ApplicationID);
+		if (bJsonBody)
+		{
+			Template.Headers.Emplace(TEXT("content-type"), TEXT("application/json"));
+		}
+	};
+	Make(ELeaderboardEndpoint::GenerateOTP, TEXT("POST"), BaseURL + TEXT("/public/auth/otp/generate"), true);
+	Make(ELeaderboardEndpoint::VerifyOTP, TEXT("POST"), BaseURL + TEXT("/public/auth/otp/verify"), true);
+	Make(ELeaderboardEndpoint::RefreshToken, TEXT("POST"), BaseURL + TEXT("/public/auth/token/refresh"), true);
+	Make(ELeaderboardEndpoint::PostScore, TEXT("POST"), BaseURL + TEXT("/public/leaderboards/sdk/score"), true);
+	Templates[static_cast<int32>(ELeaderboardEndpoint::PostScore)].Headers.Emplace(TEXT("accept"), TEXT("application/json"));
+	Make(ELeaderboardEndpoint::GetUser, TEXT("GET"), BaseURL + TEXT("/public/user/"), false);
+	Make(ELeaderboardEndpoint::TopScores, TEXT("GET"), FString::Printf(TEXT("%s/public/leaderboards/%s/top-scores?"), *BaseURL, *ApplicationID), false);
+	Make(ELeaderboardEndpoint::Profiles, TEXT("GET"), BaseURL + ProfilesPath + TEXT("?usernames="), false);
+	Make(ELeaderboardEndpoint::TopScoresBatch, TEXT("POST"), BaseURL + TopScoresBatchPath, true);
+}
+
+namespace LeaderboardJson
+{
+	void AppendEscaped(FStringBuilderBase& Builder, FStringView Value)
+	{
+		for (const TCHAR Char : Value)
+		{
+			switch (Char)
+			{
+				case TEXT('"'): Builder << TEXT("\\\""); break;
+				case TEXT('\\'): Builder << TEXT("\\\\"); break;
+				case TEXT('\n'): Builder << TEXT("\\n"); break;
+				case TEXT('\r'): Builder << TEXT("\\r"); break;
+				case TEXT('\t'): Builder << TEXT("\\t"); break;
+				default:
+					if (Char < 0x20)
+					{
+						Builder.Appendf(TEXT("\\u%04x"), static_cast<uint32>(Char));
+					}
+					else
+					{
+						Builder.AppendChar(Char);
+					}
+			}
+		}
+	}
+
+	static void AppendFieldName(FStringBuilderBase& Builder, const TCHAR* Name)
+	{
+		Builder.AppendChar(Builder.Len() == 0 ? TEXT('{') : TEXT(','));
+		Builder.AppendChar(TEXT('"'));
+		Builder.Append(Name);
+		Builder.Append(TEXT("\":"));
+	}
+
+	void AppendStringField(FStringBuilderBase& Builder, const TCHAR* Name, FStringView Value)
+	{
+		AppendFieldName(Builder, Name);
+		Builder.AppendChar(TEXT('"'));
+		AppendEscaped(Builder, Value);
+		Builder.AppendChar(TEXT('"'));
+	}
+
+	void AppendNumberField(FStringBuilderBase& Builder, const TCHAR* Name, double Value)
+	{
+		AppendFieldName(Builder, Name);
+		//Enough digits to round-trip any float score
+		Builder.Appendf(TEXT("%.9g"), Value);
+	}
+
+	void SetContent(const FHttpRequestRef& Request, FStringBuilderBase& Builder)
+	{
+		Builder.AppendChar(Builder.Len() == 0 ? TEXT('{') : TEXT('}'));
+		if (Builder.Len() == 1)
+		{
+			Builder.AppendChar(TEXT('}'));
+		}
+		//Conversion stays on the stack for bodies this size, the only heap copy is the one the request keeps
+		FTCHARToUTF8 Utf8(Builder.GetData(), Builder.Len());
+		Request->SetContent(TArray<uint8>(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length()));
+	}
+}
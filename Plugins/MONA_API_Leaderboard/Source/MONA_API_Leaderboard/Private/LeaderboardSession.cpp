@@ -0,0 +1,515 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardSession.h"
+#include "LeaderboardDiagnostics.h"
+#include "LeaderboardJsonParse.h"
+#include "http.h"
+#include "Serialization/JsonSerializer.h"
+#include "JsonObjectConverter.h"
+#include "EngineGlobals.h"
+#include "Engine/Engine.h"
+#include "LeaderboardPromise.h"
+#include "Misc/StringBuilder.h"
+
+ULeaderboardController* ULeaderboardSession::GetController() const
+{
+	//Sessions are always created with their controller as outer
+	return CastChecked<ULeaderboardController>(GetOuter());
+}
+
+bool ULeaderboardSession::IsDefaultSession() const
+{
+	return GetController()->DefaultSession == this;
+}
+
+void ULeaderboardSession::GenerateOTP(const FString& Email)
+{
+	GenerateOTPAsync(Email, [this](bool bSuccess)
+	{
+		if (!bSuccess) return;
+		OnOtpSent.Broadcast();
+		if (IsDefaultSession())
+		{
+			GetController()->OnOtpSent.Broadcast();
+		}
+	});
+}
+
+void ULeaderboardSession::VerifyOTP(const FString& Email, const FString& OTP)
+{
+	VerifyOTPAsync(Email, OTP, [this](bool bSuccess)
+	{
+		if (!bSuccess) return;
+		OnOtpVerified.Broadcast();
+		if (IsDefaultSession())
+		{
+			GetController()->OnOtpVerified.Broadcast();
+		}
+	});
+}
+
+void ULeaderboardSession::GetUser()
+{
+	GetUserAsync([this](bool bSuccess, const FUser& User)
+	{
+		if (!bSuccess) return;
+		OnUserReceived.Broadcast(User);
+		if (IsDefaultSession())
+		{
+			GetController()->OnUserReceived.Broadcast(User);
+		}
+	});
+}
+
+void ULeaderboardSession::PostScore(const float Score, const FString& Topic)
+{
+	PostScoreAsync(Score, Topic, FOnScorePostComplete([this, Score, Topic](ELeaderboardPostResult Result)
+	{
+		if (Result == ELeaderboardPostResult::Posted)
+		{
+			OnScorePosted.Broadcast();
+			if (IsDefaultSession())
+			{
+				GetController()->OnScorePosted.Broadcast();
+			}
+		}
+		else if (Result == ELeaderboardPostResult::Skipped)
+		{
+			OnScoreSkipped.Broadcast(Score, Topic);
+			if (IsDefaultSession())
+			{
+				GetController()->OnScoreSkipped.Broadcast(Score, Topic);
+			}
+		}
+	}));
+}
+
+void ULeaderboardSession::GenerateOTPAsync(const FString& Email, FOnLeaderboardRequestComplete OnComplete)
+{
+	ULeaderboardController* Controller = GetController();
+	if (!Controller->ValidAppID())
+	{
+		OnComplete(false);
+		return;
+	}
+	//Setup Request
+	FHttpRequestRef Request = Controller->RequestTemplates.Get(ELeaderboardEndpoint::GenerateOTP).Instantiate();
+	//Set Request Body
+	TStringBuilder<256> Body;
+	LeaderboardJson::AppendStringField(Body, TEXT("email"), Email);
+	LeaderboardJson::SetContent(Request, Body);
+
+	//Bind Response Received Callback
+	Controller->Scheduler.Submit(Request, ELeaderboardEndpoint::GenerateOTP, ELeaderboardRequestPriority::Auth, FLeaderboardResponseDelegate::CreateUObject(this, &ULeaderboardSession::GenerateOTPResponseReceived, MoveTemp(OnComplete)));
+}
+
+void ULeaderboardSession::VerifyOTPAsync(const FString& Email, const FString& OTP, FOnLeaderboardRequestComplete OnComplete)
+{
+	ULeaderboardController* Controller = GetController();
+	//return if invalid App ID or empty OTP
+	if (!Controller->ValidAppID() || OTP.IsEmpty())
+	{
+		OnComplete(false);
+		return;
+	}
+	//Setup Request
+	FHttpRequestRef Request = Controller->RequestTemplates.Get(ELeaderboardEndpoint::VerifyOTP).Instantiate();
+	//Set Request Body
+	TStringBuilder<256> Body;
+	LeaderboardJson::AppendStringField(Body, TEXT("email"), Email);
+	LeaderboardJson::AppendStringField(Body, TEXT("otp"), OTP);
+	LeaderboardJson::SetContent(Request, Body);
+
+	//Bind Response Received Callback
+	Controller->Scheduler.Submit(Request, ELeaderboardEndpoint::VerifyOTP, ELeaderboardRequestPriority::Auth, FLeaderboardResponseDelegate::CreateUObject(this, &ULeaderboardSession::VerifyOTPResponseReceived, MoveTemp(OnComplete)));
+}
+
+void ULeaderboardSession::GetUserAsync(FOnUserComplete OnComplete)
+{
+	ULeaderboardController* Controller = GetController();
+	if (!Controller->ValidAppID() || !IsAuthorized())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: Leaderboard Session Access Token has not been set"));
+		OnComplete(false, FUser());
+		return;
+	}
+	RunAuthorized([this, OnComplete = MoveTemp(OnComplete)](bool bAuthorized)
+	{
+		if (!bAuthorized)
+		{
+			OnComplete(false, FUser());
+			return;
+		}
+		SendGetUser(OnComplete, true);
+	});
+}
+
+void ULeaderboardSession::SendGetUser(FOnUserComplete OnComplete, bool bConditional)
+{
+	ULeaderboardController* Controller = GetController();
+	//Setup Request
+	const FLeaderboardRequestTemplate& Template = Controller->RequestTemplates.Get(ELeaderboardEndpoint::GetUser);
+	FHttpRequestRef Request = Template.Instantiate();
+	Request->SetHeader("Authorization", Credentials.Load()->AuthorizationHeader);
+	if (bConditional)
+	{
+		UserCache.ApplyValidators(Template.URL, Request);
+	}
+
+	//Bind Response Received Callback
+	Controller->Scheduler.Submit(Request, ELeaderboardEndpoint::GetUser, ELeaderboardRequestPriority::VisibleBoard, FLeaderboardResponseDelegate::CreateUObject(this, &ULeaderboardSession::GetUserResponseReceived, bConditional, MoveTemp(OnComplete)));
+}
+
+void ULeaderboardSession::PostScoreAsync(const float Score, const FString& Topic, FOnLeaderboardRequestComplete OnComplete)
+{
+	PostScoreAsync(Score, Topic, FOnScorePostComplete([OnComplete = MoveTemp(OnComplete)](ELeaderboardPostResult Result)
+	{
+		OnComplete(Result == ELeaderboardPostResult::Posted);
+	}));
+}
+
+void ULeaderboardSession::PostScoreAsync(const float Score, const FString& Topic, FOnScorePostComplete OnComplete)
+{
+	ELeaderboardRequestPriority Priority = ELeaderboardRequestPriority::ScorePost;
+	const ELeaderboardScoreFilter Filter = GetController()->NonImprovingScores;
+	if (Filter != ELeaderboardScoreFilter::PostAll && !PersonalBests.WouldImprove(Topic, Score, FDateTime::UtcNow()))
+	{
+		if (Filter == ELeaderboardScoreFilter::Skip)
+		{
+			//Best-per-player boards of this topic would not change. The caller decides whether that matters
+			UE_LOG(LogTemp, Verbose, TEXT("Skipping score %f for topic '%s', not a personal best"), Score, *Topic);
+			OnComplete(ELeaderboardPostResult::Skipped);
+			return;
+		}
+		Priority = ELeaderboardRequestPriority::Prefetch;
+	}
+	SendScore(Score, Topic, Priority, true, [OnComplete = MoveTemp(OnComplete)](bool bSuccess)
+	{
+		OnComplete(bSuccess ? ELeaderboardPostResult::Posted : ELeaderboardPostResult::Failed);
+	});
+}
+
+TFuture<bool> ULeaderboardSession::GenerateOTPAsync(const FString& Email)
+{
+	TSharedRef<TLeaderboardPromise<bool>> Promise = MakeShared<TLeaderboardPromise<bool>>(false);
+	TFuture<bool> Future = Promise->GetFuture();
+	GenerateOTPAsync(Email, [Promise](bool bSuccess) { Promise->SetValue(bSuccess); });
+	return Future;
+}
+
+TFuture<bool> ULeaderboardSession::VerifyOTPAsync(const FString& Email, const FString& OTP)
+{
+	TSharedRef<TLeaderboardPromise<bool>> Promise = MakeShared<TLeaderboardPromise<bool>>(false);
+	TFuture<bool> Future = Promise->GetFuture();
+	VerifyOTPAsync(Email, OTP, [Promise](bool bSuccess) { Promise->SetValue(bSuccess); });
+	return Future;
+}
+
+TFuture<bool> ULeaderboardSession::PostScoreAsync(const float Score, const FString& Topic)
+{
+	TSharedRef<TLeaderboardPromise<bool>> Promise = MakeShared<TLeaderboardPromise<bool>>(false);
+	TFuture<bool> Future = Promise->GetFuture();
+	PostScoreAsync(Score, Topic, [Promise](bool bSuccess) { Promise->SetValue(bSuccess); });
+	return Future;
+}
+
+TFuture<TOptional<FUser>> ULeaderboardSession::GetUserAsync()
+{
+	TSharedRef<TLeaderboardPromise<TOptional<FUser>>> Promise = MakeShared<TLeaderboardPromise<TOptional<FUser>>>();
+	TFuture<TOptional<FUser>> Future = Promise->GetFuture();
+	GetUserAsync([Promise](bool bSuccess, const FUser& User)
+	{
+		Promise->SetValue(bSuccess ? TOptional<FUser>(User) : TOptional<FUser>());
+	});
+	return Future;
+}
+
+void ULeaderboardSession::RefreshAccessToken()
+{
+	ULeaderboardController* Controller = GetController();
+	if (bRefreshInFlight) return;
+	if (!Controller->ValidAppID() || !ValidAuthorization())
+	{
+		//Nothing will ever refresh the token, so nothing waiting on it can go out
+		TArray<TFunction<void(bool bAuthorized)>> Awaiting = MoveTemp(AwaitingRefresh);
+		AwaitingRefresh.Reset();
+		for (TFunction<void(bool bAuthorized)>& Send : Awaiting)
+		{
+			Send(false);
+		}
+		return;
+	}
+	//Setup Request
+	FHttpRequestRef Request = Controller->RequestTemplates.Get(ELeaderboardEndpoint::RefreshToken).Instantiate();
+	//Set Request Body
+	TStringBuilder<1024> Body;
+	LeaderboardJson::AppendStringField(Body, TEXT("refresh"), Credentials.Load()->RefreshToken);
+	LeaderboardJson::SetContent(Request, Body);
+
+	bRefreshInFlight = true;
+	//Bind Response Received Callback
+	Controller->Scheduler.Submit(Request, ELeaderboardEndpoint::RefreshToken, ELeaderboardRequestPriority::Auth, FLeaderboardResponseDelegate::CreateUObject(this, &ULeaderboardSession::RefreshAccessTokenResponseReceived));
+}
+
+void ULeaderboardSession::SetTokens(const FString& InAccessToken, const FString& InRefreshToken)
+{
+	FLeaderboardCredentials NewCredentials;
+	NewCredentials.SetAccessToken(InAccessToken);
+	NewCredentials.RefreshToken = InRefreshToken;
+	Credentials.Store(MoveTemp(NewCredentials));
+	UserCache.Empty();
+	PersonalBests.Empty();
+}
+
+void ULeaderboardSession::SendScore(const float Score, const FString& Topic, ELeaderboardRequestPriority Priority, bool bRetryOnUnauthorized, FOnLeaderboardRequestComplete OnComplete)
+{
+	ULeaderboardController* Controller = GetController();
+	if (!Controller->ValidAppID() || !ValidAuthorization())
+	{
+		OnComplete(false);
+		return;
+	}
+	if (Controller->GetConfig()->SDKSecret.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Error: LeaderboardController SDKSecret has not been set"));
+		OnComplete(false);
+		return;
+	}
+	RunAuthorized([this, Score, Topic, Priority, bRetryOnUnauthorized, OnComplete = MoveTemp(OnComplete)](bool bAuthorized)
+	{
+		if (!bAuthorized)
+		{
+			OnComplete(false);
+			return;
+		}
+		ULeaderboardController* Controller = GetController();
+		//Sign score:timestamp:topic
+		const int64 Timestamp = FDateTime::UtcNow().ToUnixTimestamp();
+		TStringBuilder<128> TimestampString;
+		TimestampString << Timestamp;
+		TStringBuilder<256> Message;
+		Message << FString::SanitizeFloat(Score, 3) << TEXT(':') << TimestampString << TEXT(':') << Topic;
+		const FString Signature = ULeaderboardController::GenerateHmac(FString(Message.ToView()), Controller->GetConfig()->SDKSecret);
+
+		//Setup Request
+		FHttpRequestRef Request = Controller->RequestTemplates.Get(ELeaderboardEndpoint::PostScore).Instantiate();
+		Request->SetHeader("Authorization", Credentials.Load()->AuthorizationHeader);
+		//Set Request Body
+		TStringBuilder<256> Body;
+		LeaderboardJson::AppendNumberField(Body, TEXT("score"), Score);
+		LeaderboardJson::AppendStringField(Body, TEXT("timestamp"), TimestampString.ToView());
+		LeaderboardJson::AppendStringField(Body, TEXT("signature"), Signature);
+		LeaderboardJson::SetContent(Request, Body);
+
+		//Bind Response Received Callback
+		Controller->Scheduler.Submit(Request, ELeaderboardEndpoint::PostScore, Priority, FLeaderboardResponseDelegate::CreateUObject(this, &ULeaderboardSession::ScorePostedResponseReceived, Score, Topic, Priority, bRetryOnUnauthorized, OnComplete));
+	});
+}
+
+void ULeaderboardSession::RunAuthorized(TFunction<void(bool bAuthorized)>&& Send)
+{
+	//A refresh is pending, the current access token is known to be stale
+	if (bRefreshInFlight)
+	{
+		AwaitingRefresh.Add(MoveTemp(Send));
+		return;
+	}
+	Send(true);
+}
+
+bool ULeaderboardSession::GetPersonalBest(const FString& Topic, ELeaderboardPeriod Period, float& OutScore) const
+{
+	double Best = 0.0;
+	if (!PersonalBests.GetBest(Topic, Period, FDateTime::UtcNow(), Best)) return false;
+	OutScore = static_cast<float>(Best);
+	return true;
+}
+
+bool ULeaderboardSession::IsAuthorized() const
+{
+	return Credentials.Load()->IsAuthorized();
+}
+
+bool ULeaderboardSession::GetTokens(FString& OutAccessToken, FString& OutRefreshToken) const
+{
+	//One snapshot, so the pair always belongs together
+	const std::shared_ptr<const FLeaderboardCredentials> Snapshot = Credentials.Load();
+	OutAccessToken = Snapshot->AccessToken;
+	OutRefreshToken = Snapshot->RefreshToken;
+	return Snapshot->IsAuthorized();
+}
+
+bool ULeaderboardSession::ValidAuthorization() const
+{
+	if (!IsAuthorized())
+	{
+#if WITH_LEADERBOARD_DIAGNOSTICS
+		if (GetController()->bShowDebug && FLeaderboardDiagnostics::IsVisible())
+		{
+			FLeaderboardDiagnostics::AddMessage(FString::Printf(TEXT("Error: AccessToken / RefreshToken of session '%s' has not been validated"), *PlayerID));
+		}
+#endif
+		return false;
+	}
+	return true;
+}
+
+bool ULeaderboardSession::ParseTokens(FUtf8StringView Content, FString& OutAccessToken, FString& OutRefreshToken)
+{
+	OutAccessToken.Reset();
+	OutRefreshToken.Reset();
+	TSharedPtr<FJsonObject> ResponseObj;
+	if (!LeaderboardJson::Parse(Content, ResponseObj, MaxAuthResponseBytes)) return false;
+	//Wrong types count as missing
+	ResponseObj->TryGetStringField(TEXT("access"), OutAccessToken);
+	ResponseObj->TryGetStringField(TEXT("refresh"), OutRefreshToken);
+	return true;
+}
+
+bool ULeaderboardSession::ParseUser(FUtf8StringView Content, FUser& OutUser)
+{
+	TSharedPtr<FJsonObject> ResponseObj;
+	if (!LeaderboardJson::Parse(Content, ResponseObj, MaxAuthResponseBytes)) return false;
+	return FJsonObjectConverter::JsonObjectToUStruct<FUser>(ResponseObj.ToSharedRef(), &OutUser);
+}
+
+void ULeaderboardSession::ScorePostedResponseReceived(const FLeaderboardHttpResponse& Response, float Score, FString Topic, ELeaderboardRequestPriority Priority, bool bRetryOnUnauthorized, FOnLeaderboardRequestComplete OnComplete)
+{
+	if (Response.IsValid())
+	{
+		if (Response.Code == 200)
+		{
+			PersonalBests.RecordPost(Topic, Score, FDateTime::UtcNow());
+			GetController()->InvalidateTopic(Topic);
+			OnComplete(true);
+			return;
+		}
+		if (Response.Code == 401)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("401 Unauthorized - Refreshing Access Token"));
+			//Retry once with the new token. Every post failing in the same burst shares this one refresh
+			if (bRetryOnUnauthorized)
+			{
+				AwaitingRefresh.Add([this, Score, Topic, Priority, OnComplete](bool bAuthorized)
+				{
+					if (bAuthorized)
+					{
+						SendScore(Score, Topic, Priority, false, OnComplete);
+					}
+					else
+					{
+						OnComplete(false);
+					}
+				});
+				RefreshAccessToken();
+				return;
+			}
+			RefreshAccessToken();
+		}
+	}
+	OnComplete(false);
+}
+
+void ULeaderboardSession::GenerateOTPResponseReceived(const FLeaderboardHttpResponse& Response, FOnLeaderboardRequestComplete OnComplete)
+{
+	OnComplete(Response.Code == 200);
+}
+
+void ULeaderboardSession::VerifyOTPResponseReceived(const FLeaderboardHttpResponse& Response, FOnLeaderboardRequestComplete OnComplete)
+{
+	if (!GetController()->ValidResponse(Response, this))
+	{
+		OnComplete(false);
+		return;
+	}
+	//Get Access and Refresh Token, published together
+	FString OutAccessToken;
+	FString OutRefreshToken;
+	if (!ParseTokens(Response.GetContentAsUtf8(), OutAccessToken, OutRefreshToken))
+	{
+		OnComplete(false);
+		return;
+	}
+	Credentials.Update([&](FLeaderboardCredentials& NewCredentials)
+	{
+		if (!OutAccessToken.IsEmpty()) NewCredentials.SetAccessToken(OutAccessToken);
+		if (!OutRefreshToken.IsEmpty()) NewCredentials.RefreshToken = OutRefreshToken;
+	});
+	//A new login may be a different user
+	UserCache.Empty();
+	PersonalBests.Empty();
+	OnComplete(IsAuthorized());
+}
+
+void ULeaderboardSession::GetUserResponseReceived(const FLeaderboardHttpResponse& Response, bool bConditional, FOnUserComplete OnComplete)
+{
+	if (!GetController()->ValidResponse(Response, this))
+	{
+		OnComplete(false, FUser());
+		return;
+	}
+	//Not modified, reuse the user parsed last time
+	if (Response.Code == 304)
+	{
+		const TLeaderboardResponseCache<FUser>::FEntry* Cached = UserCache.Find(Response.URL);
+		if (Cached == nullptr)
+		{
+			//Evicted or expired while in flight. Ask again without validators, a 304 to that is a broken server
+			UserCache.Remove(Response.URL);
+			if (bConditional)
+			{
+				SendGetUser(MoveTemp(OnComplete), false);
+			}
+			else
+			{
+				OnComplete(false, FUser());
+			}
+			return;
+		}
+		CurrentUser = Cached->Value;
+	}
+	else
+	{
+		FUser User;
+		if (!ParseUser(Response.GetContentAsUtf8(), User))
+		{
+			OnComplete(false, FUser());
+			return;
+		}
+		UserCache.Store(Response.URL, FLeaderboardValidators::FromResponse(Response), User);
+		CurrentUser = User;
+	}
+	OnComplete(true, CurrentUser);
+}
+
+void ULeaderboardSession::RefreshAccessTokenResponseReceived(const FLeaderboardHttpResponse& Response)
+{
+	bRefreshInFlight = false;
+	TArray<TFunction<void(bool bAuthorized)>> Awaiting = MoveTemp(AwaitingRefresh);
+	AwaitingRefresh.Reset();
+	bool bRefreshed = false;
+	if (Response.Code == 200)
+	{
+		//Rotating refresh tokens come back alongside the access token
+		FString OutAccessToken;
+		FString OutRefreshToken;
+		if (ParseTokens(Response.GetContentAsUtf8(), OutAccessToken, OutRefreshToken) && !OutAccessToken.IsEmpty())
+		{
+			Credentials.Update([&](FLeaderboardCredentials& NewCredentials)
+			{
+				NewCredentials.SetAccessToken(OutAccessToken);
+				if (!OutRefreshToken.IsEmpty()) NewCredentials.RefreshToken = OutRefreshToken;
+			});
+			bRefreshed = true;
+		}
+	}
+	if (!bRefreshed)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Access token refresh failed for session '%s', failing %d queued request(s)"), *PlayerID, Awaiting.Num());
+	}
+	//Replay (or fail) everything that waited for the new token
+	for (TFunction<void(bool bAuthorized)>& Send : Awaiting)
+	{
+		Send(bRefreshed);
+	}
+}
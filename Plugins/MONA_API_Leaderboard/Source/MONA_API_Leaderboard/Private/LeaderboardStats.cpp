@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardStats.h"
+#include "Misc/Parse.h"
+
+FLeaderboardOperationBudget FLeaderboardOperationBudget::Parse(const TCHAR* Args)
+{
+	FLeaderboardOperationBudget Budget;
+	int32 Requests = 0;
+	if (FParse::Value(Args, TEXT("Requests="), Requests))
+	{
+		Budget.MaxRequests = Requests;
+	}
+	double GameThreadMs = 0.0;
+	if (FParse::Value(Args, TEXT("GameThreadMs="), GameThreadMs))
+	{
+		Budget.MaxGameThreadMs = GameThreadMs;
+	}
+	int64 Bytes = 0;
+	if (FParse::Value(Args, TEXT("Bytes="), Bytes))
+	{
+		Budget.MaxResponseBytes = Bytes;
+	}
+	int64 AllocatedKB = 0;
+	if (FParse::Value(Args, TEXT("AllocatedKB="), AllocatedKB))
+	{
+		Budget.MaxGameThreadAllocatedBytes = AllocatedKB * 1024;
+	}
+	return Budget;
+}
+
+void FLeaderboardStats::RecordRequest(ELeaderboardEndpoint Endpoint)
+{
+	Endpoints[static_cast<int32>(Endpoint)].NumRequests++;
+}
+
+void FLeaderboardStats::RecordResponse(ELeaderboardEndpoint Endpoint, const FLeaderboardHttpResponse& Response, double GameThreadSeconds, int64 GameThreadAllocatedBytes)
+{
+	FLeaderboardEndpointStats& Stats = Endpoints[static_cast<int32>(Endpoint)];
+	if (!Response.IsValid() || Response.Code >= 400)
+	{
+		Stats.NumFailed++;
+	}
+	else if (Response.Code == 304)
+	{
+		Stats.NumNotModified++;
+	}
+	Stats.LastLatency = Response.Latency;
+	const int64 Bytes = Response.GetContent().Num();
+	Stats.TotalResponseBytes += Bytes;
+	Stats.MaxResponseBytes = FMath::Max(Stats.MaxResponseBytes, Bytes);
+	Stats.TotalGameThreadSeconds += GameThreadSeconds;
+	Stats.MaxGameThreadSeconds = FMath::Max(Stats.MaxGameThreadSeconds, GameThreadSeconds);
+	Stats.TotalGameThreadAllocatedBytes += GameThreadAllocatedBytes;
+	Stats.MaxGameThreadAllocatedBytes = FMath::Max(Stats.MaxGameThreadAllocatedBytes, GameThreadAllocatedBytes);
+}
+
+void FLeaderboardStats::Reset()
+{
+	for (FLeaderboardEndpointStats& Stats : Endpoints)
+	{
+		Stats = FLeaderboardEndpointStats();
+	}
+}
+
+bool FLeaderboardStats::CheckBudget(ELeaderboardEndpoint Endpoint, const FLeaderboardOperationBudget& Budget) const
+{
+	const FLeaderboardEndpointStats& Stats = Get(Endpoint);
+	bool bWithinBudget = true;
+	if (Budget.MaxRequests.IsSet() && Stats.NumRequests > Budget.MaxRequests.GetValue())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Leaderboard budget exceeded: %s made %d request(s), budget %d"), LexToString(Endpoint), Stats.NumRequests, Budget.MaxRequests.GetValue());
+		bWithinBudget = false;
+	}
+	if (Budget.MaxGameThreadMs.IsSet() && Stats.MaxGameThreadSeconds * 1000.0 > Budget.MaxGameThreadMs.GetValue())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Leaderboard budget exceeded: %s took %.3f ms on the game thread, budget %.3f ms"), LexToString(Endpoint), Stats.MaxGameThreadSeconds * 1000.0, Budget.MaxGameThreadMs.GetValue());
+		bWithinBudget = false;
+	}
+	if (Budget.MaxResponseBytes.IsSet() && Stats.MaxResponseBytes > Budget.MaxResponseBytes.GetValue())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Leaderboard budget exceeded: %s received %lld bytes, budget %lld"), LexToString(Endpoint), Stats.MaxResponseBytes, Budget.MaxResponseBytes.GetValue());
+		bWithinBudget = false;
+	}
+	if (Budget.MaxGameThreadAllocatedBytes.IsSet() && Stats.MaxGameThreadAllocatedBytes > Budget.MaxGameThreadAllocatedBytes.GetValue())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Leaderboard budget exceeded: %s allocated %lld bytes on the game thread, budget %lld"), LexToString(Endpoint), Stats.MaxGameThreadAllocatedBytes, Budget.MaxGameThreadAllocatedBytes.GetValue());
+		bWithinBudget = false;
+	}
+	if (bWithinBudget)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Leaderboard budget met: %s"), LexToString(Endpoint));
+	}
+	return bWithinBudget;
+}
+
+void FLeaderboardStats::Dump() const
+{
+	UE_LOG(LogTemp, Display, TEXT("%-14s %8s %8s %12s %12s %10s %10s %12s"), TEXT("Endpoint"), TEXT("Requests"), TEXT("Failed"), TEXT("Bytes"), TEXT("MaxBytes"), TEXT("GT ms"), TEXT("MaxGT ms"), TEXT("MaxGT alloc"));
+	for (int32 Index = 0; Index < static_cast<int32>(ELeaderboardEndpoint::Count); ++Index)
+	{
+		const FLeaderboardEndpointStats& Stats = Endpoints[Index];
+		UE_LOG(LogTemp, Display, TEXT("%-14s %8d %8d %12lld %12lld %10.3f %10.3f %12lld"), LexToString(static_cast<ELeaderboardEndpoint>(Index)),
+			Stats.NumRequests, Stats.NumFailed, Stats.TotalResponseBytes, Stats.MaxResponseBytes,
+			Stats.TotalGameThreadSeconds * 1000.0, Stats.MaxGameThreadSeconds * 1000.0, Stats.MaxGameThreadAllocatedBytes);
+	}
+}
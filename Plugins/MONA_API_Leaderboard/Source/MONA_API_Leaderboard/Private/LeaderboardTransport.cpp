@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeaderboardTransport.h"
+
+FString FLeaderboardHttpResponse::GetHeader(const FString& HeaderName) const
+{
+	if (HttpResponse.IsValid())
+	{
+		return HttpResponse->GetHeader(HeaderName);
+	}
+	for (const FString& Header : OwnedHeaders)
+	{
+		FString Name, Value;
+		if (Header.Split(TEXT(":"), &Name, &Value) && Name.TrimStartAndEnd().Equals(HeaderName, ESearchCase::IgnoreCase))
+		{
+			return Value.TrimStartAndEnd();
+		}
+	}
+	return FString();
+}
+
+TArray<FString> FLeaderboardHttpResponse::GetAllHeaders() const
+{
+	return HttpResponse.IsValid() ? HttpResponse->GetAllHeaders() : OwnedHeaders;
+}
+
+TArrayView<const uint8> FLeaderboardHttpResponse::GetContent() const
+{
+	if (HttpResponse.IsValid())
+	{
+		return HttpResponse->GetContent();
+	}
+	return OwnedContent;
+}
+
+FUtf8StringView FLeaderboardHttpResponse::GetContentAsUtf8() const
+{
+	const TArrayView<const uint8> Content = GetContent();
+	return FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Content.GetData()), Content.Num());
+}
+
+FString FLeaderboardHttpResponse::GetContentAsString() const
+{
+	const TArrayView<const uint8> Content = GetContent();
+	FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Content.GetData()), Content.Num());
+	return FString(Converter.Length(), Converter.Get());
+}
+
+FLeaderboardHttpResponse FLeaderboardHttpResponse::FromHttp(const FHttpRequestPtr& Request, const FHttpResponsePtr& Response, bool bConnectedSuccessfully)
+{
+	FLeaderboardHttpResponse Result;
+	Result.URL = Request.IsValid() ? Request->GetURL() : FString();
+	if (bConnectedSuccessfully && Response.IsValid())
+	{
+		Result.Code = Response->GetResponseCode();
+		Result.HttpResponse = Response;
+	}
+	return Result;
+}
+
+FLeaderboardHttpResponse FLeaderboardHttpResponse::FromData(const FString& URL, int32 Code, TArray<FString>&& Headers, TArray<uint8>&& Content)
+{
+	FLeaderboardHttpResponse Result;
+	Result.URL = URL;
+	Result.Code = Code;
+	Result.OwnedHeaders = MoveTemp(Headers);
+	Result.OwnedContent = MoveTemp(Content);
+	return Result;
+}
+
+void FLeaderboardHttpTransport::Send(const FHttpRequestRef& Request, TFunction<void(const FLeaderboardHttpResponse&)>&& OnComplete)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	Request->OnProcessRequestComplete().BindLambda([OnComplete = MoveTemp(OnComplete), StartTime](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bConnectedSuccessfully)
+	{
+		FLeaderboardHttpResponse Response = FLeaderboardHttpResponse::FromHttp(HttpRequest, HttpResponse, bConnectedSuccessfully);
+		Response.Latency = FPlatformTime::Seconds() - StartTime;
+		OnComplete(Response);
+	});
+	if (!Request->ProcessRequest())
+	{
+		//Could not start, report it as a connection failure so the caller still hears back
+		FHttpRequestCompleteDelegate Delegate = Request->OnProcessRequestComplete();
+		Request->OnProcessRequestComplete().Unbind();
+		Delegate.ExecuteIfBound(Request, nullptr, false);
+	}
+}
+
+void FLeaderboardHttpTransport::Cancel(const FHttpRequestRef& Request)
+{
+	Request->OnProcessRequestComplete().Unbind();
+	Request->CancelRequest();
+}
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "MONA_API_Leaderboard.h"
+#include "LeaderboardDiagnostics.h"
 
 #define LOCTEXT_NAMESPACE "FMONA_API_LeaderboardModule"
 
@@ -13,6 +14,9 @@ void FMONA_API_LeaderboardModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+#if WITH_LEADERBOARD_DIAGNOSTICS
+	FLeaderboardDiagnostics::SetVisible(false);
+#endif
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeaderboardAllocationCounter.h"
+#include "Async/Async.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardAllocationCounterScopeTest, "MonaLeaderboard.AllocationCounter.Scopes",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLeaderboardAllocationCounterScopeTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 BlockBytes = 64 * 1024;
+	const bool bCountingBytes = FLeaderboardAllocationCounter::Install();
+	int64 OuterAllocations = 0;
+	int64 OuterPeak = 0;
+	int64 InnerPeak = 0;
+	int64 OtherThreadBytes = 0;
+	{
+		const FLeaderboardAllocationCounter::FScope Outer;
+		void* Large = FMemory::Malloc(BlockBytes);
+		FMemory::Free(Large);
+		{
+			//Starts below the outer peak, so restarting it must not lower the outer one
+			const FLeaderboardAllocationCounter::FScope Inner;
+			void* Small = FMemory::Malloc(16);
+			FMemory::Free(Small);
+			InnerPeak = Inner.GetPeakBytes();
+		}
+		//Allocates on another thread while this one is counting
+		const int64 BeforeOtherThread = Outer.GetAllocatedBytes();
+		Async(EAsyncExecution::Thread, []()
+		{
+			TArray<uint8> Buffer;
+			Buffer.SetNumUninitialized(BlockBytes);
+		}).Wait();
+		OtherThreadBytes = Outer.GetAllocatedBytes() - BeforeOtherThread;
+		OuterAllocations = Outer.GetNumAllocations();
+		OuterPeak = Outer.GetPeakBytes();
+	}
+	FLeaderboardAllocationCounter::Uninstall();
+
+	TestTrue(TEXT("The outer scope counts the inner scope's allocations"), OuterAllocations >= 2);
+	if (bCountingBytes)
+	{
+		//The future's own bookkeeping is allocated here, the buffer is not
+		TestTrue(TEXT("Allocations of other threads are not counted"), OtherThreadBytes < BlockBytes);
+		TestTrue(TEXT("The inner peak restarted"), InnerPeak < BlockBytes);
+		TestTrue(TEXT("The outer peak survived the inner scope"), OuterPeak >= BlockBytes);
+	}
+	else
+	{
+		AddWarning(TEXT("The allocator does not report block sizes, peaks are not checked"));
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeaderboardCoroutines.h"
+#include "LeaderboardTestStandIn.h"
+
+namespace LeaderboardCoroutines
+{
+	using namespace LeaderboardTest;
+
+	//MonaLeaderboard::GetTopScores against the stand-in's controller instead of the singleton
+	static TLeaderboardOperation<TOptional<FScores>> GetTopScores(ULeaderboardController* Controller, const FLeaderboardQuery& Query, FLeaderboardRequestHandle* OutHandle = nullptr)
+	{
+		return MonaLeaderboard::Private::Start<TOptional<FScores>>(Controller, FLeaderboardAwaitOptions(), [Controller, Query, OutHandle](TFunction<void(TOptional<FScores>)> Done)
+		{
+			const FLeaderboardRequestHandle Handle = Controller->GetTopScoresAsync(Query, [Done = MoveTemp(Done)](bool bSuccess, const FScores& Scores)
+			{
+				Done(bSuccess ? TOptional<FScores>(Scores) : TOptional<FScores>());
+			});
+			if (OutHandle)
+			{
+				*OutHandle = Handle;
+			}
+			return Handle;
+		});
+	}
+
+	//Awaits Dropped, then chains a second request from inside the resumption
+	static FLeaderboardCoroutine AwaitThenChain(TWeakObjectPtr<ULeaderboardController> Controller, FLeaderboardQuery Query, TLeaderboardOperation<TOptional<FScores>> Dropped, TSharedRef<TArray<FString>> Log)
+	{
+		const TOptional<FScores> First = co_await Dropped;
+		Log->Add(First.IsSet() ? TEXT("first succeeded") : TEXT("first failed"));
+		if (!Controller.IsValid()) co_return;
+		const TOptional<FScores> Second = co_await GetTopScores(Controller.Get(), Query);
+		Log->Add(Second.IsSet() ? TEXT("second succeeded") : TEXT("second failed"));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardCoroutineCancelQueuedTest, "MonaLeaderboard.Coroutines.CancelQueuedThenChain",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLeaderboardCoroutineCancelQueuedTest::RunTest(const FString& Parameters)
+{
+	using namespace LeaderboardCoroutines;
+	FStandIn StandIn;
+	FLeaderboardQuery Query;
+	Query.Topic = Topic;
+	FLeaderboardRecording Recording;
+	AddExchange(Recording, TEXT("GET"), StandIn.Controller->BuildTopScoresURL(Query), 200, MakeBoard(10));
+	StandIn.Answer(Recording);
+	//One slot, so the awaited request waits in the queue behind the first
+	StandIn.Controller->SetMaxConcurrentRequests(1);
+
+	TLeaderboardOperation<TOptional<FScores>> InFlight = GetTopScores(StandIn.Controller, Query);
+	FLeaderboardRequestHandle QueuedHandle;
+	TLeaderboardOperation<TOptional<FScores>> Queued = GetTopScores(StandIn.Controller, Query, &QueuedHandle);
+	TestEqual(TEXT("The awaited request is queued"), StandIn.Controller->GetScheduler().GetNumQueued(), 1);
+
+	TSharedRef<TArray<FString>> Log = MakeShared<TArray<FString>>();
+	AwaitThenChain(StandIn.Controller, Query, Queued, Log);
+	TestTrue(TEXT("Cancelled while queued"), StandIn.Controller->CancelRequest(QueuedHandle));
+	//Resuming here would submit the chained request while the scheduler is still removing the cancelled one
+	TestEqual(TEXT("Nothing resumes from inside the cancellation"), Log->Num(), 0);
+
+	StandIn.RunUntil([&]() { return Log->Num() == 2 && InFlight.IsDone(); });
+	TestEqual(TEXT("Both awaits resumed"), Log->Num(), 2);
+	if (Log->Num() == 2)
+	{
+		TestEqual(TEXT("The cancelled await"), (*Log)[0], FString(TEXT("first failed")));
+		TestEqual(TEXT("The chained await"), (*Log)[1], FString(TEXT("second succeeded")));
+	}
+	TestTrue(TEXT("The request ahead of it was unaffected"), InFlight.IsDone());
+	TestEqual(TEXT("Requests dispatched"), StandIn.GetStats().Get(ELeaderboardEndpoint::TopScores).NumRequests, 2);
+	return true;
+}
+
+#endif
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeaderboardExport.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace LeaderboardExportTest
+{
+	//Scores fall and ranks rise row by row, usernames repeat so the block dictionaries are shared
+	static FScores MakeBoard(int32 NumRows, int32 FirstScore, const TCHAR* Topic)
+	{
+		FScores Scores;
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			FUserInfo& Info = Scores.Items.AddDefaulted_GetRef();
+			Info.ID = FirstScore + Row;
+			Info.User.Username = FString::Printf(TEXT("player%d"), Row % 3);
+			Info.User.Name = FString::Printf(TEXT("Player %d"), Row);
+			Info.Score = FirstScore - Row * 7;
+			Info.Topic = Topic;
+			Info.Created_At = FString::Printf(TEXT("2024-01-%02dT12:34:56.789Z"), Row + 1);
+			Info.Rank = Row + 1;
+		}
+		Scores.Count = Scores.Items.Num();
+		return Scores;
+	}
+
+	static bool SameRow(const FUserInfo& A, const FUserInfo& B)
+	{
+		return A.ID == B.ID && A.Rank == B.Rank && A.Score == B.Score && A.Topic == B.Topic && A.Created_At == B.Created_At
+			&& A.User.Username == B.User.Username && A.User.Name == B.User.Name;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardExportRoundTripTest, "MonaLeaderboard.Export.RoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLeaderboardExportRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace LeaderboardExportTest;
+	//Same topic, different period and order: only the key tells these boards apart
+	TArray<TPair<FString, FScores>> Boards;
+	Boards.Emplace(TEXT("https://leaderboard.test/top-scores?topic=level1&period=all_time&order=highest"), MakeBoard(8, 9000, TEXT("level1")));
+	Boards.Emplace(TEXT("https://leaderboard.test/top-scores?topic=level1&period=week&order=highest"), MakeBoard(2, 500, TEXT("level1")));
+	Boards.Emplace(TEXT("https://leaderboard.test/top-scores?topic=level1&period=all_time&order=lowest"), MakeBoard(5, -40, TEXT("level1")));
+
+	const FString Path = FPaths::CreateTempFilename(*FPaths::ProjectSavedDir(), TEXT("LeaderboardExport"), TEXT(".mlbc"));
+	{
+		//Three rows per block, so a board spans several blocks and ends on a partial one
+		FLeaderboardColumnarWriter Writer(3);
+		if (!TestTrue(TEXT("Opened for writing"), Writer.Open(Path))) return false;
+		for (const TPair<FString, FScores>& Board : Boards)
+		{
+			Writer.BeginBoard(Board.Key);
+			Writer.Add(Board.Value);
+		}
+		TestEqual(TEXT("Rows written"), Writer.GetNumRows(), 15LL);
+		TestTrue(TEXT("Closed"), Writer.Close());
+	}
+
+	{
+		//Block by block: each block belongs to exactly one board, in the order written
+		FLeaderboardColumnarReader Reader;
+		if (TestTrue(TEXT("Opened for reading"), Reader.Open(Path)))
+		{
+			int32 BoardIndex = 0;
+			int32 RowIndex = 0;
+			int32 NumBlocks = 0;
+			TArray<FUserInfo> Block;
+			while (Reader.ReadBlock(Block))
+			{
+				++NumBlocks;
+				while (BoardIndex < Boards.Num() && RowIndex == Boards[BoardIndex].Value.Items.Num())
+				{
+					++BoardIndex;
+					RowIndex = 0;
+				}
+				if (!TestTrue(TEXT("No more blocks than written"), BoardIndex < Boards.Num())) break;
+				TestEqual(TEXT("Block key"), Reader.GetBoardKey(), Boards[BoardIndex].Key);
+				for (const FUserInfo& Row : Block)
+				{
+					const TArray<FUserInfo>& Expected = Boards[BoardIndex].Value.Items;
+					if (!TestTrue(TEXT("Block stays within its board"), RowIndex < Expected.Num())) break;
+					TestTrue(FString::Printf(TEXT("Row %d of board %d"), RowIndex, BoardIndex), SameRow(Row, Expected[RowIndex]));
+					++RowIndex;
+				}
+			}
+			TestFalse(TEXT("Read without error"), Reader.HasError());
+			//3+3+2, 2, 3+2
+			TestEqual(TEXT("Blocks"), NumBlocks, 6);
+			TestTrue(TEXT("Every row read back"), BoardIndex == Boards.Num() - 1 && RowIndex == Boards.Last().Value.Items.Num());
+		}
+	}
+
+	{
+		TMap<FString, FScores> Loaded;
+		TestTrue(TEXT("Loaded by board"), FLeaderboardColumnarReader::LoadBoards(Path, Loaded));
+		TestEqual(TEXT("Boards"), Loaded.Num(), Boards.Num());
+		for (const TPair<FString, FScores>& Board : Boards)
+		{
+			const FScores* Found = Loaded.Find(Board.Key);
+			if (!TestNotNull(*Board.Key, Found)) continue;
+			TestEqual(*Board.Key, Found->Items.Num(), Board.Value.Items.Num());
+			for (int32 Row = 0; Row < FMath::Min(Found->Items.Num(), Board.Value.Items.Num()); ++Row)
+			{
+				TestTrue(FString::Printf(TEXT("%s row %d"), *Board.Key, Row), SameRow(Found->Items[Row], Board.Value.Items[Row]));
+			}
+		}
+	}
+
+	IFileManager::Get().Delete(*Path);
+	return true;
+}
+
+#endif
@@ -0,0 +1,250 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeaderboardController.h"
+#include "LeaderboardSession.h"
+#include "LeaderboardAllocationCounter.h"
+#include "LeaderboardTestStandIn.h"
+
+/**
+ * The controller's flows end to end against the stand-in server (see LeaderboardTestStandIn.h). Request counts are
+ * exact; game-thread time and allocations are checked against the budgets below through FLeaderboardStats,
+ * allocations counted at the allocator.
+ */
+namespace LeaderboardFlow
+{
+	using namespace LeaderboardTest;
+
+	static const TCHAR* SDKSecret = TEXT("flow-test-secret");
+	static const TCHAR* Email = TEXT("player@example.com");
+
+	//A default top-scores request, see NumTopScoresToGet
+	static constexpr int32 BoardSize = 50;
+	//Any single completion handler has to fit in a 60 Hz frame
+	static constexpr double HandlerGameThreadMs = 16.0;
+	//Parsing, caching and handing out a top-50 board, worst of the first fetch and the refresh
+	static constexpr int64 TopScoresAllocatedKB = 512;
+	static constexpr int64 PostScoreAllocatedKB = 16;
+	//Fewer than the scheduler's concurrency, so every post of the burst is in flight before the refresh returns
+	static constexpr int32 BurstSize = 3;
+
+	//Allocation limits are left out where the allocator cannot report block sizes
+	static FLeaderboardOperationBudget HandlerBudget(bool bCountingBytes, int64 AllocatedKB)
+	{
+		FLeaderboardOperationBudget Budget;
+		Budget.MaxGameThreadMs = HandlerGameThreadMs;
+		if (bCountingBytes)
+		{
+			Budget.MaxGameThreadAllocatedBytes = AllocatedKB * 1024;
+		}
+		return Budget;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardFlowTopScoresTest, "MonaLeaderboard.Flow.TopScores",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLeaderboardFlowTopScoresTest::RunTest(const FString& Parameters)
+{
+	using namespace LeaderboardFlow;
+	FStandIn StandIn;
+	FLeaderboardQuery Query;
+	Query.Topic = Topic;
+	const FString URL = StandIn.Controller->BuildTopScoresURL(Query);
+	//The board, then the same board again answered from the cache
+	FLeaderboardRecording Recording;
+	AddExchange(Recording, TEXT("GET"), URL, 200, MakeBoard(BoardSize), {TEXT("ETag: \"board-1\"")});
+	AddExchange(Recording, TEXT("GET"), URL, 304, FString(), {TEXT("ETag: \"board-1\"")});
+	StandIn.Answer(Recording);
+
+	const bool bCountingBytes = FLeaderboardAllocationCounter::Install();
+	TArray<FScores> Boards;
+	int32 NumFailed = 0;
+	auto OnComplete = [&Boards, &NumFailed](bool bSuccess, const FScores& Scores)
+	{
+		if (bSuccess)
+		{
+			Boards.Add(Scores);
+		}
+		else
+		{
+			NumFailed++;
+		}
+	};
+	StandIn.Controller->GetTopScoresAsync(Query, OnComplete);
+	StandIn.RunUntil([&]() { return Boards.Num() + NumFailed == 1; });
+	StandIn.Controller->GetTopScoresAsync(Query, OnComplete);
+	StandIn.RunUntil([&]() { return Boards.Num() + NumFailed == 2; });
+	FLeaderboardAllocationCounter::Uninstall();
+
+	TestEqual(TEXT("Both fetches succeeded"), Boards.Num(), 2);
+	if (Boards.Num() == 2)
+	{
+		TestEqual(TEXT("Rows on the board"), Boards[0].Items.Num(), BoardSize);
+		TestEqual(TEXT("The refresh returns the cached board"), Boards[1].Items.Num(), BoardSize);
+	}
+	const FLeaderboardEndpointStats& Stats = StandIn.GetStats().Get(ELeaderboardEndpoint::TopScores);
+	TestEqual(TEXT("One request per fetch"), Stats.NumRequests, 2);
+	TestEqual(TEXT("The refresh was conditional"), Stats.NumNotModified, 1);
+	TestEqual(TEXT("Requests to unrecorded URLs"), StandIn.Transport->GetNumUnmatched(), 0);
+	AddInfo(FString::Printf(TEXT("Top-%d handler: %.3f ms, %lld bytes allocated at most"), BoardSize, Stats.MaxGameThreadSeconds * 1000.0, Stats.MaxGameThreadAllocatedBytes));
+	if (bCountingBytes)
+	{
+		TestTrue(TEXT("Allocations were counted"), Stats.MaxGameThreadAllocatedBytes > 0);
+	}
+	else
+	{
+		AddWarning(TEXT("The allocator does not report block sizes, allocation budgets are not checked"));
+	}
+	TestTrue(TEXT("TopScores within budget"), StandIn.GetStats().CheckBudget(ELeaderboardEndpoint::TopScores, HandlerBudget(bCountingBytes, TopScoresAllocatedKB)));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardFlowClientPostScoreTest, "MonaLeaderboard.Flow.ClientPostScore",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLeaderboardFlowClientPostScoreTest::RunTest(const FString& Parameters)
+{
+	using namespace LeaderboardFlow;
+	FStandIn StandIn;
+	FLeaderboardRecording Recording;
+	AddExchange(Recording, TEXT("POST"), Endpoint(TEXT("/public/leaderboards/sdk/score")), 200, TEXT("{}"));
+	StandIn.Answer(Recording);
+	StandIn.Controller->GetDefaultSession()->SetTokens(TEXT("access"), TEXT("refresh"));
+
+	const bool bCountingBytes = FLeaderboardAllocationCounter::Install();
+	StandIn.Controller->ClientPostScore(1200.f, Topic, SDKSecret);
+	const bool bFinished = StandIn.RunUntil([&]() { return StandIn.IsIdle(); });
+	FLeaderboardAllocationCounter::Uninstall();
+
+	TestTrue(TEXT("The post completed"), bFinished);
+	TestEqual(TEXT("The secret passed along was adopted"), StandIn.Controller->GetConfig()->SDKSecret, FString(SDKSecret));
+	const FLeaderboardEndpointStats& Stats = StandIn.GetStats().Get(ELeaderboardEndpoint::PostScore);
+	TestEqual(TEXT("One request per post"), Stats.NumRequests, 1);
+	TestEqual(TEXT("Failed posts"), Stats.NumFailed, 0);
+	TestEqual(TEXT("Refreshes"), StandIn.GetStats().Get(ELeaderboardEndpoint::RefreshToken).NumRequests, 0);
+	float Best = 0.f;
+	TestTrue(TEXT("The accepted score became the personal best"), StandIn.Controller->GetDefaultSession()->GetPersonalBest(Topic, ELeaderboardPeriod::all_time, Best));
+	TestEqual(TEXT("Personal best"), Best, 1200.f);
+	TestTrue(TEXT("PostScore within budget"), StandIn.GetStats().CheckBudget(ELeaderboardEndpoint::PostScore, HandlerBudget(bCountingBytes, PostScoreAllocatedKB)));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardFlowOTPTest, "MonaLeaderboard.Flow.OTP",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLeaderboardFlowOTPTest::RunTest(const FString& Parameters)
+{
+	using namespace LeaderboardFlow;
+	FStandIn StandIn;
+	FLeaderboardRecording Recording;
+	AddExchange(Recording, TEXT("POST"), Endpoint(TEXT("/public/auth/otp/generate")), 200, TEXT("{}"));
+	AddExchange(Recording, TEXT("POST"), Endpoint(TEXT("/public/auth/otp/verify")), 200, MakeTokens(TEXT("otp-access"), TEXT("otp-refresh")));
+	StandIn.Answer(Recording);
+	ULeaderboardSession* Session = StandIn.Controller->GetDefaultSession();
+
+	TOptional<bool> bSent;
+	Session->GenerateOTPAsync(Email, [&bSent](bool bSuccess) { bSent = bSuccess; });
+	StandIn.RunUntil([&]() { return bSent.IsSet(); });
+	TestTrue(TEXT("The OTP was sent"), bSent.Get(false));
+
+	TOptional<bool> bVerified;
+	Session->VerifyOTPAsync(Email, TEXT("123456"), [&bVerified](bool bSuccess) { bVerified = bSuccess; });
+	StandIn.RunUntil([&]() { return bVerified.IsSet(); });
+	TestTrue(TEXT("The OTP was verified"), bVerified.Get(false));
+
+	FString Access;
+	FString Refresh;
+	TestTrue(TEXT("The session is authorized"), Session->GetTokens(Access, Refresh));
+	TestEqual(TEXT("Access token"), Access, FString(TEXT("otp-access")));
+	TestEqual(TEXT("Refresh token"), Refresh, FString(TEXT("otp-refresh")));
+	const FLeaderboardStats& Stats = StandIn.GetStats();
+	TestEqual(TEXT("GenerateOTP requests"), Stats.Get(ELeaderboardEndpoint::GenerateOTP).NumRequests, 1);
+	TestEqual(TEXT("VerifyOTP requests"), Stats.Get(ELeaderboardEndpoint::VerifyOTP).NumRequests, 1);
+	TestEqual(TEXT("Refreshes"), Stats.Get(ELeaderboardEndpoint::RefreshToken).NumRequests, 0);
+	TestTrue(TEXT("VerifyOTP within budget"), Stats.CheckBudget(ELeaderboardEndpoint::VerifyOTP, HandlerBudget(false, 0)));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardFlowRefreshBurstTest, "MonaLeaderboard.Flow.RefreshBurst",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLeaderboardFlowRefreshBurstTest::RunTest(const FString& Parameters)
+{
+	using namespace LeaderboardFlow;
+	FStandIn StandIn;
+	//Every post is rejected once with the stale token, then accepted
+	FLeaderboardRecording Recording;
+	const FString PostURL = Endpoint(TEXT("/public/leaderboards/sdk/score"));
+	for (int32 Post = 0; Post < BurstSize; ++Post)
+	{
+		AddExchange(Recording, TEXT("POST"), PostURL, 401, TEXT("{}"));
+	}
+	AddExchange(Recording, TEXT("POST"), PostURL, 200, TEXT("{}"));
+	AddExchange(Recording, TEXT("POST"), Endpoint(TEXT("/public/auth/token/refresh")), 200, MakeTokens(TEXT("fresh-access"), TEXT("fresh-refresh")));
+	StandIn.Answer(Recording);
+	StandIn.Controller->ServerSetSDKSecret(SDKSecret);
+	ULeaderboardSession* Session = StandIn.Controller->GetDefaultSession();
+	Session->SetTokens(TEXT("stale-access"), TEXT("refresh"));
+
+	TArray<ELeaderboardPostResult> Results;
+	for (int32 Post = 0; Post < BurstSize; ++Post)
+	{
+		Session->PostScoreAsync(1000.f + Post, Topic, FOnScorePostComplete([&Results](ELeaderboardPostResult Result) { Results.Add(Result); }));
+	}
+	StandIn.RunUntil([&]() { return Results.Num() == BurstSize; });
+
+	TestEqual(TEXT("Every post completed"), Results.Num(), BurstSize);
+	for (const ELeaderboardPostResult Result : Results)
+	{
+		TestTrue(TEXT("The post went through after the refresh"), Result == ELeaderboardPostResult::Posted);
+	}
+	const FLeaderboardStats& Stats = StandIn.GetStats();
+	TestEqual(TEXT("One 401 burst causes exactly one refresh"), Stats.Get(ELeaderboardEndpoint::RefreshToken).NumRequests, 1);
+	TestEqual(TEXT("Every post is retried exactly once"), Stats.Get(ELeaderboardEndpoint::PostScore).NumRequests, BurstSize * 2);
+	FString Access;
+	FString Refresh;
+	Session->GetTokens(Access, Refresh);
+	TestEqual(TEXT("Access token after the refresh"), Access, FString(TEXT("fresh-access")));
+	TestEqual(TEXT("Rotated refresh token"), Refresh, FString(TEXT("fresh-refresh")));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardFlowRefreshFailureTest, "MonaLeaderboard.Flow.RefreshFailure",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLeaderboardFlowRefreshFailureTest::RunTest(const FString& Parameters)
+{
+	using namespace LeaderboardFlow;
+	FStandIn StandIn;
+	//The refresh token was revoked as well
+	FLeaderboardRecording Recording;
+	AddExchange(Recording, TEXT("POST"), Endpoint(TEXT("/public/leaderboards/sdk/score")), 401, TEXT("{}"));
+	AddExchange(Recording, TEXT("POST"), Endpoint(TEXT("/public/auth/token/refresh")), 401, TEXT("{}"));
+	StandIn.Answer(Recording);
+	StandIn.Controller->ServerSetSDKSecret(SDKSecret);
+	ULeaderboardSession* Session = StandIn.Controller->GetDefaultSession();
+	Session->SetTokens(TEXT("stale-access"), TEXT("revoked-refresh"));
+
+	TArray<ELeaderboardPostResult> Results;
+	for (int32 Post = 0; Post < BurstSize; ++Post)
+	{
+		Session->PostScoreAsync(1000.f + Post, Topic, FOnScorePostComplete([&Results](ELeaderboardPostResult Result) { Results.Add(Result); }));
+	}
+	StandIn.RunUntil([&]() { return Results.Num() == BurstSize; });
+
+	TestEqual(TEXT("Every post completed"), Results.Num(), BurstSize);
+	for (const ELeaderboardPostResult Result : Results)
+	{
+		TestTrue(TEXT("The post failed with the refresh"), Result == ELeaderboardPostResult::Failed);
+	}
+	const FLeaderboardStats& Stats = StandIn.GetStats();
+	TestEqual(TEXT("One 401 burst causes exactly one refresh"), Stats.Get(ELeaderboardEndpoint::RefreshToken).NumRequests, 1);
+	TestEqual(TEXT("Nothing is retried without a token"), Stats.Get(ELeaderboardEndpoint::PostScore).NumRequests, BurstSize);
+	return true;
+}
+
+#endif
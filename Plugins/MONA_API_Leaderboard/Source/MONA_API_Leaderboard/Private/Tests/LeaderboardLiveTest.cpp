@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeaderboardController.h"
+#include "LeaderboardTestStandIn.h"
+
+namespace LeaderboardLive
+{
+	using namespace LeaderboardTest;
+
+	static constexpr int32 BoardSize = 10;
+	static constexpr float PollInterval = 0.1f;
+
+	static int32 GetLiveTopScore(ULeaderboardController* Controller)
+	{
+		FScores Board;
+		return Controller->GetLiveBoard(Board) && Board.Items.Num() > 0 ? Board.Items[0].Score : 0;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardLiveNotModifiedTest, "MonaLeaderboard.Live.NotModifiedSeedsBoard",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLeaderboardLiveNotModifiedTest::RunTest(const FString& Parameters)
+{
+	using namespace LeaderboardLive;
+	FStandIn StandIn;
+	FLeaderboardQuery Query;
+	Query.Topic = Topic;
+	//The board for GetTopScores, then unchanged for every live poll
+	FLeaderboardRecording Recording;
+	const FString URL = StandIn.Controller->BuildTopScoresURL(Query);
+	AddExchange(Recording, TEXT("GET"), URL, 200, MakeBoard(BoardSize), {TEXT("ETag: \"board-1\"")});
+	AddExchange(Recording, TEXT("GET"), URL, 304, FString(), {TEXT("ETag: \"board-1\"")});
+	StandIn.Answer(Recording);
+
+	bool bFetched = false;
+	StandIn.Controller->GetTopScoresAsync(Query, [&bFetched](bool bSuccess, const FScores& Scores) { bFetched = bSuccess; });
+	StandIn.RunUntil([&]() { return bFetched; });
+	TestTrue(TEXT("The board was fetched"), bFetched);
+
+	StandIn.Controller->StartLiveLeaderboard(Query, PollInterval, PollInterval);
+	FScores LiveBoard;
+	const bool bLive = StandIn.RunUntil([&]() { return StandIn.Controller->GetLiveBoard(LiveBoard); });
+	StandIn.Controller->StopLiveLeaderboard();
+
+	TestTrue(TEXT("A 304 on the first poll still gives the live board"), bLive);
+	TestEqual(TEXT("Rows on the live board"), LiveBoard.Items.Num(), BoardSize);
+	const FLeaderboardEndpointStats& Stats = StandIn.GetStats().Get(ELeaderboardEndpoint::TopScores);
+	TestTrue(TEXT("The live poll was conditional"), Stats.NumNotModified >= 1);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardLivePollsUntilConnectedTest, "MonaLeaderboard.Live.PollsUntilStreamConnects",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FLeaderboardLivePollsUntilConnectedTest::RunTest(const FString& Parameters)
+{
+	using namespace LeaderboardLive;
+	FStandIn StandIn;
+	FLeaderboardQuery Query;
+	Query.Topic = Topic;
+	//Nothing listens there: the stream never connects, whether or not the attempt ever reports an error
+	StandIn.Controller->LiveLeaderboardStreamURL = TEXT("ws://127.0.0.1:9/live");
+	//The board, then a new leader
+	FLeaderboardRecording Recording;
+	const FString URL = StandIn.Controller->BuildTopScoresURL(Query);
+	AddExchange(Recording, TEXT("GET"), URL, 200, MakeBoard(BoardSize, 100000));
+	AddExchange(Recording, TEXT("GET"), URL, 200, MakeBoard(BoardSize, 200000));
+	StandIn.Answer(Recording);
+
+	StandIn.Controller->StartLiveLeaderboard(Query, PollInterval, PollInterval);
+	const bool bSeeded = StandIn.RunUntil([&]() { return GetLiveTopScore(StandIn.Controller) == 100000; });
+	const bool bUpdated = StandIn.RunUntil([&]() { return GetLiveTopScore(StandIn.Controller) == 200000; });
+	StandIn.Controller->StopLiveLeaderboard();
+
+	TestTrue(TEXT("The first poll seeded the live board"), bSeeded);
+	TestTrue(TEXT("Polling went on while the stream was not connected"), bUpdated);
+	TestTrue(TEXT("Polls"), StandIn.GetStats().Get(ELeaderboardEndpoint::TopScores).NumRequests >= 2);
+	return true;
+}
+
+#endif
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeaderboardController.h"
+#include "LeaderboardReplay.h"
+#include "Containers/Ticker.h"
+
+/**
+ * Stand-in server for the automation tests: a controller of its own whose requests are answered by a replay
+ * transport fed with exchanges built in the test, on the next tick. The singleton's tokens, caches and transport
+ * are never touched.
+ */
+namespace LeaderboardTest
+{
+	inline const TCHAR* BaseURL = TEXT("https://leaderboard.test");
+	inline const TCHAR* ApplicationID = TEXT("00000000-0000-0000-0000-000000000000");
+	inline const TCHAR* Topic = TEXT("level1");
+
+	inline FString Endpoint(const TCHAR* Path)
+	{
+		return FString(BaseURL) + Path;
+	}
+
+	inline void AddExchange(FLeaderboardRecording& Recording, const TCHAR* Verb, const FString& URL, int32 Code, const FString& Body, const TArray<FString>& Headers = TArray<FString>())
+	{
+		FLeaderboardRecordedExchange& Exchange = Recording.Exchanges.AddDefaulted_GetRef();
+		Exchange.Verb = Verb;
+		Exchange.URL = URL;
+		Exchange.Code = Code;
+		Exchange.ResponseHeaders = Headers;
+		Exchange.ResponseHeaders.Add(TEXT("Content-Type: application/json"));
+		const FTCHARToUTF8 Utf8(*Body);
+		Exchange.ResponseBody.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	}
+
+	//FirstScore for the top row, each following row 100 lower
+	inline FString MakeBoard(int32 NumRows, int32 FirstScore = 100000)
+	{
+		TArray<FString> Rows;
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			Rows.Add(FString::Printf(TEXT("{\"id\":%d,\"user\":{\"username\":\"player%d\",\"name\":\"Player %d\"},\"score\":%d,\"topic\":\"%s\",\"created_at\":\"2024-01-01T00:00:00Z\",\"rank\":%d}"),
+				Row + 1, Row, Row, FirstScore - Row * 100, Topic, Row + 1));
+		}
+		return FString::Printf(TEXT("{\"items\":[%s],\"count\":%d}"), *FString::Join(Rows, TEXT(",")), NumRows);
+	}
+
+	inline FString MakeTokens(const TCHAR* Access, const TCHAR* Refresh)
+	{
+		return FString::Printf(TEXT("{\"access\":\"%s\",\"refresh\":\"%s\"}"), Access, Refresh);
+	}
+
+	class FStandIn
+	{
+	public:
+		FStandIn()
+		{
+			Controller = NewObject<ULeaderboardController>();
+			Controller->AddToRoot();
+			Controller->SetBaseURL(BaseURL);
+			Controller->SetApplicationID(ApplicationID);
+		}
+
+		~FStandIn()
+		{
+			//Nothing may call back into the test's locals once it has returned
+			Controller->GetScheduler().CancelAll();
+			Controller->RemoveFromRoot();
+			Controller->MarkAsGarbage();
+		}
+
+		//Requests dispatched from now on are answered from Recording
+		void Answer(const FLeaderboardRecording& Recording)
+		{
+			Transport = MakeShared<FLeaderboardReplayTransport>(Recording, 0.f);
+			Controller->GetScheduler().SetTransport(Transport.ToSharedRef());
+		}
+
+		//Ticks in real time until Done, false if it never was. Live polling paces itself by the clock
+		bool RunUntil(TFunctionRef<bool()> Done, double TimeoutSeconds = 5.0)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			double LastTime = StartTime;
+			while (!Done() && LastTime - StartTime < TimeoutSeconds)
+			{
+				const double Now = FPlatformTime::Seconds();
+				FTSTicker::GetCoreTicker().Tick(static_cast<float>(Now - LastTime));
+				LastTime = Now;
+				FPlatformProcess::Sleep(0.001f);
+			}
+			return Done();
+		}
+
+		bool IsIdle() const
+		{
+			return Controller->GetScheduler().GetNumInFlight() == 0 && Controller->GetScheduler().GetNumQueued() == 0;
+		}
+
+		FLeaderboardStats& GetStats() const { return Controller->GetScheduler().GetStats(); }
+
+		ULeaderboardController* Controller = nullptr;
+		TSharedPtr<FLeaderboardReplayTransport> Transport;
+	};
+}
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Counts the allocations made through GMalloc, for the fuzz harness, the request benchmark and the automation tests.
+ * Install puts a forwarding proxy in front of the allocator; byte counts come from the allocator's own block sizes,
+ * so they are only available where it reports them (the binned allocators do). Only allocations made by a thread while
+ * it is inside an FScope are counted, into that thread's own totals; other threads go straight through. The proxy
+ * stays in place once installed, Uninstall only stops the counting.
+ */
+class MONA_API_LEADERBOARD_API FLeaderboardAllocationCounter
+{
+public:
+	//False if the allocator cannot report block sizes; allocations are still counted, bytes stay 0
+	static bool Install();
+	static void Uninstall();
+	static bool IsInstalled();
+
+	//Deltas of the constructing thread since construction. Scopes nest: an inner one restarts the peak for itself
+	//and hands the enclosing scope's back, raised by whatever the inner one reached
+	class MONA_API_LEADERBOARD_API FScope
+	{
+	public:
+		FScope();
+		~FScope();
+
+		FScope(const FScope&) = delete;
+		FScope& operator=(const FScope&) = delete;
+
+		int64 GetNumAllocations() const;
+		int64 GetAllocatedBytes() const;
+		//Highest growth of live bytes over the start of the scope
+		int64 GetPeakBytes() const;
+
+	private:
+		int64 StartAllocations = 0;
+		int64 StartAllocatedBytes = 0;
+		int64 StartLiveBytes = 0;
+		int64 EnclosingPeakBytes = 0;
+	};
+};
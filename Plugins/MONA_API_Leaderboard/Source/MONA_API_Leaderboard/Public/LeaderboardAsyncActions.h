@@ -0,0 +1,158 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "LeaderboardController.h"
+#include "LeaderboardAsyncActions.generated.h"
+
+class ULeaderboardSession;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FTopScoresAsyncPin, const FScores&, TopScores);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FTopScoresMultiAsyncPin, const FLeaderboardMultiResult&, Result);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FUserAsyncPin, const FUser&, User);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FLeaderboardAsyncPin);
+
+/**
+ * Latent Blueprint nodes for the controller calls. Each node only reports back to the graph that
+ * spawned it, through its own success and failure pins, instead of the controller's global delegates.
+ * A null Session means the controller's default session. A node whose request is cancelled fires its failure pin.
+ */
+UCLASS()
+class MONA_API_LEADERBOARD_API UGetTopScoresAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+public:
+	UFUNCTION(BlueprintCallable, Category= "LeaderboardController", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UGetTopScoresAsyncAction* GetTopScoresAsync(UObject* WorldContextObject, const FLeaderboardQuery& Query);
+
+	UPROPERTY(BlueprintAssignable)
+	FTopScoresAsyncPin OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FTopScoresAsyncPin OnFailure;
+
+	virtual void Activate() override;
+
+private:
+	FLeaderboardQuery Query;
+};
+
+//OnFailure still carries every board that arrived before the deadline
+UCLASS()
+class MONA_API_LEADERBOARD_API UGetTopScoresMultiAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+public:
+	UFUNCTION(BlueprintCallable, Category= "LeaderboardController", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UGetTopScoresMultiAsyncAction* GetTopScoresMultiAsync(UObject* WorldContextObject, const TArray<FLeaderboardQuery>& Queries, float TimeoutSeconds = 5.f);
+
+	UPROPERTY(BlueprintAssignable)
+	FTopScoresMultiAsyncPin OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FTopScoresMultiAsyncPin OnFailure;
+
+	virtual void Activate() override;
+
+private:
+	TArray<FLeaderboardQuery> Queries;
+	float TimeoutSeconds = 5.f;
+};
+
+UCLASS()
+class MONA_API_LEADERBOARD_API UPostScoreAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+public:
+	UFUNCTION(BlueprintCallable, Category= "LeaderboardController", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UPostScoreAsyncAction* PostScoreAsync(UObject* WorldContextObject, ULeaderboardSession* Session, float Score, const FString& Topic);
+
+	UPROPERTY(BlueprintAssignable)
+	FLeaderboardAsyncPin OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FLeaderboardAsyncPin OnFailure;
+
+	//Not sent, see ULeaderboardController::NonImprovingScores
+	UPROPERTY(BlueprintAssignable)
+	FLeaderboardAsyncPin OnSkipped;
+
+	virtual void Activate() override;
+
+private:
+	UPROPERTY()
+	TObjectPtr<ULeaderboardSession> Session;
+
+	float Score = 0.f;
+	FString Topic;
+};
+
+UCLASS()
+class MONA_API_LEADERBOARD_API UGenerateOTPAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+public:
+	UFUNCTION(BlueprintCallable, Category= "Authorization", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UGenerateOTPAsyncAction* GenerateOTPAsync(UObject* WorldContextObject, ULeaderboardSession* Session, const FString& Email);
+
+	UPROPERTY(BlueprintAssignable)
+	FLeaderboardAsyncPin OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FLeaderboardAsyncPin OnFailure;
+
+	virtual void Activate() override;
+
+private:
+	UPROPERTY()
+	TObjectPtr<ULeaderboardSession> Session;
+
+	FString Email;
+};
+
+UCLASS()
+class MONA_API_LEADERBOARD_API UVerifyOTPAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+public:
+	UFUNCTION(BlueprintCallable, Category= "Authorization", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UVerifyOTPAsyncAction* VerifyOTPAsync(UObject* WorldContextObject, ULeaderboardSession* Session, const FString& Email, const FString& OTP);
+
+	UPROPERTY(BlueprintAssignable)
+	FLeaderboardAsyncPin OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FLeaderboardAsyncPin OnFailure;
+
+	virtual void Activate() override;
+
+private:
+	UPROPERTY()
+	TObjectPtr<ULeaderboardSession> Session;
+
+	FString Email;
+	FString OTP;
+};
+
+UCLASS()
+class MONA_API_LEADERBOARD_API UGetUserAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+public:
+	UFUNCTION(BlueprintCallable, Category= "Authorization", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UGetUserAsyncAction* GetUserAsync(UObject* WorldContextObject, ULeaderboardSession* Session);
+
+	UPROPERTY(BlueprintAssignable)
+	FUserAsyncPin OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FUserAsyncPin OnFailure;
+
+	virtual void Activate() override;
+
+private:
+	UPROPERTY()
+	TObjectPtr<ULeaderboardSession> Session;
+};
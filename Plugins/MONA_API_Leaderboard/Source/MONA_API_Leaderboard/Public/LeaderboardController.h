@@ -2,9 +2,17 @@
 
 #pragma once
 
-#include <mutex>
 #include "CoreMinimal.h"
 #include "Interfaces/IHttpRequest.h"
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
+#include "LeaderboardRequestScheduler.h"
+#include "LeaderboardResponseCache.h"
+#include "LeaderboardRequestTemplates.h"
+#include "LeaderboardReplay.h"
+#include "LeaderboardProfileCache.h"
+#include "LeaderboardCredentials.h"
+#include "LeaderboardNavigationModel.h"
 #include "LeaderboardController.generated.h"
 
 USTRUCT(BlueprintType)
@@ -55,6 +63,22 @@ struct FScores
 	int Count;
 };
 
+//Heap bytes held by parsed responses, for the memory budget
+inline int64 GetLeaderboardAllocatedSize(const FUser& User)
+{
+	return User.Username.GetAllocatedSize() + User.Name.GetAllocatedSize();
+}
+
+inline int64 GetLeaderboardAllocatedSize(const FScores& Scores)
+{
+	int64 Bytes = Scores.Items.GetAllocatedSize();
+	for (const FUserInfo& Info : Scores.Items)
+	{
+		Bytes += GetLeaderboardAllocatedSize(Info.User) + Info.Topic.GetAllocatedSize() + Info.Created_At.GetAllocatedSize();
+	}
+	return Bytes;
+}
+
 UENUM(BlueprintType)
 enum class ELeaderboardPeriod : uint8
 {
@@ -71,16 +95,113 @@ enum class ELeaderboardSortingOrder : uint8
 	lowest
 };
 
+//Parameters of a single top-scores query, same as the GetTopScores arguments
+USTRUCT(BlueprintType)
+struct FLeaderboardQuery
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard Query")
+	bool bFeatured = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard Query")
+	FString Topic;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard Query")
+	ELeaderboardPeriod Period = ELeaderboardPeriod::all_time;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard Query")
+	ELeaderboardSortingOrder Order = ELeaderboardSortingOrder::highest;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard Query")
+	FString StartTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard Query")
+	FString EndTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard Query")
+	bool bIncludeAllUsersScores = false;
+};
+
+//One board of a GetTopScoresMulti call
+USTRUCT(BlueprintType)
+struct FLeaderboardMultiBoard
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Score Info")
+	FLeaderboardQuery Query;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Score Info")
+	bool bSuccess = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Score Info")
+	FScores Scores;
+};
+
+USTRUCT(BlueprintType)
+struct FLeaderboardMultiResult
+{
+	GENERATED_BODY()
+
+	//Same order as the queries
+	UPROPERTY(BlueprintReadOnly, Category = "Score Info")
+	TArray<FLeaderboardMultiBoard> Boards;
+
+	//False if the deadline passed first. Boards still missing then have bSuccess false
+	UPROPERTY(BlueprintReadOnly, Category = "Score Info")
+	bool bComplete = false;
+};
+
+//What sessions do with a score that cannot beat the player's known best for its topic. Topics whose sort order
+//no board has shown yet, and topics shown with bIncludeAllUsersScores, are always posted
+UENUM(BlueprintType)
+enum class ELeaderboardScoreFilter : uint8
+{
+	PostAll,
+	//Still posted, after every other request
+	Demote,
+	//Not posted, reported as ELeaderboardPostResult::Skipped
+	Skip
+};
+
+//Outcome of a score post. Skipped scores never reached the server, bool callbacks see them as false
+UENUM(BlueprintType)
+enum class ELeaderboardPostResult : uint8
+{
+	Posted,
+	Failed,
+	Skipped
+};
+
+class IWebSocket;
+class FJsonObject;
+class ULeaderboardSession;
+struct FLeaderboardMultiFetch;
+
 //Delegates for broadcasting top scores, OTP Verified, etc.
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTopScoresReceived, const FScores&, TopScores);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTopScoresMultiReceived, const FLeaderboardMultiResult&, Result);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnLiveLeaderboardChanged, const FScores&, Board, const TArray<FUserInfo>&, ChangedRows);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnOTPVerified);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnOTPSent);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnScorePosted);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnScoreSkipped, float, Score, const FString&, Topic);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUserReceived, const FUser&, User);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnProfileResolved, const FLeaderboardProfile&, Profile);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLeaderboardPeriodRolledOver, ELeaderboardPeriod, Period);
+
+//Per-call completion callbacks of the native API. Unlike the delegates above they only reach the caller
+using FOnTopScoresComplete = TFunction<void(bool bSuccess, const FScores& Scores)>;
+using FOnTopScoresMultiComplete = TFunction<void(const FLeaderboardMultiResult& Result)>;
+using FOnUserComplete = TFunction<void(bool bSuccess, const FUser& User)>;
+using FOnLeaderboardRequestComplete = TFunction<void(bool bSuccess)>;
+using FOnScorePostComplete = TFunction<void(ELeaderboardPostResult Result)>;
 /**
  * 
  */
 UCLASS(BlueprintType, Blueprintable)
-class ULeaderboardController : public UObject
+class MONA_API_LEADERBOARD_API ULeaderboardController : public UObject
 {
 	GENERATED_BODY()
 public:
@@ -90,11 +211,29 @@ public:
 
 	//Setters
 	UFUNCTION(BlueprintCallable, Category= "LeaderboardController")
-	void SetApplicationID(const FString& InApplicationID) { ApplicationID = InApplicationID; }
+	void SetApplicationID(const FString& InApplicationID);
 
+	UFUNCTION(BlueprintCallable, Category= "LeaderboardController")
+	void SetBaseURL(const FString& InBaseURL);
+
+	//The controller has no owning connection, so this and ClientPostScore only ever run locally.
+	//Dedicated servers should use ULeaderboardPlayerComponent instead
 	UFUNCTION(BlueprintCallable, Server, Reliable, Category= "LeaderboardController")
 	void ServerSetSDKSecret(const FString& InSDKSecret);
 
+	//Sessions. Each local or remote player gets its own tokens; the default session backs the calls below
+	UFUNCTION(BlueprintCallable, Category= "Authorization")
+	ULeaderboardSession* CreateSession(const FString& PlayerID);
+
+	UFUNCTION(BlueprintPure, Category= "Authorization")
+	ULeaderboardSession* FindSession(const FString& PlayerID) const;
+
+	UFUNCTION(BlueprintCallable, Category= "Authorization")
+	void RemoveSession(const FString& PlayerID);
+
+	UFUNCTION(BlueprintPure, Category= "Authorization")
+	ULeaderboardSession* GetDefaultSession();
+
 	//Authorization
 	UFUNCTION(BlueprintCallable, Category= "Authorization")
 	void GenerateOTP(const FString& Email);
@@ -109,8 +248,9 @@ public:
 	/* UFUNCTION(BlueprintCallable, Category= "LeaderboardController")
 	void GetTopScores(); */
 
+	//Returns a handle that can be passed to CancelRequest. A newer call supersedes (cancels) an older one still pending
 	UFUNCTION(BlueprintCallable, Category= "LeaderboardController")
-	void GetTopScores(
+	FLeaderboardRequestHandle GetTopScores(
 	bool featured = false, 
 	FString topic = "", 
 	ELeaderboardPeriod period = ELeaderboardPeriod::all_time, 
@@ -119,13 +259,131 @@ public:
 	FString endTime = "", 
 	bool includeAllUsersScores = false);
 	
+	//Several boards at once, e.g. every topic and period of a results screen. They arrive together in a single
+	//OnTopScoresMultiReceived once all are in or TimeoutSeconds have passed, whichever comes first
+	UFUNCTION(BlueprintCallable, Category= "LeaderboardController")
+	void GetTopScoresMulti(const TArray<FLeaderboardQuery>& Queries, float TimeoutSeconds = 5.f);
+
 	UFUNCTION(BlueprintCallable, Client, Reliable, Category= "LeaderboardController")
 	void ClientPostScore(const float Score, const FString& Topic = "", const FString& InSDKSecret = "");
 
+	//Live leaderboard. Uses LiveLeaderboardStreamURL when set, otherwise conditional polling that backs off while the board is unchanged.
+	//OnTopScoresReceived and OnLiveLeaderboardChanged only fire when the board actually changed
+	UFUNCTION(BlueprintCallable, Category= "Live Leaderboard")
+	void StartLiveLeaderboard(const FLeaderboardQuery& Query, float MinPollInterval = 2.f, float MaxPollInterval = 30.f);
+
+	UFUNCTION(BlueprintCallable, Category= "Live Leaderboard")
+	void StopLiveLeaderboard();
+
+	UFUNCTION(BlueprintPure, Category= "Live Leaderboard")
+	bool IsLiveLeaderboardActive() const { return bLiveActive; }
+
+	//Empty until the first board has arrived
+	UFUNCTION(BlueprintPure, Category= "Live Leaderboard")
+	bool GetLiveBoard(FScores& OutBoard) const
+	{
+		OutBoard = LiveBoard;
+		return bHasLiveBoard;
+	}
+
+	//Native per-call API. Does not fire OnTopScoresReceived and never supersedes other requests
+	FLeaderboardRequestHandle GetTopScoresAsync(const FLeaderboardQuery& Query, FOnTopScoresComplete OnComplete, ELeaderboardRequestPriority Priority = ELeaderboardRequestPriority::VisibleBoard);
+	//Resolves to an unset optional on failure or cancellation
+	TFuture<TOptional<FScores>> GetTopScoresAsync(const FLeaderboardQuery& Query);
+
+	//Native per-call version of GetTopScoresMulti. OnComplete is called exactly once
+	void GetTopScoresMultiAsync(const TArray<FLeaderboardQuery>& Queries, FOnTopScoresMultiComplete OnComplete, float TimeoutSeconds = 5.f);
+
+	FString BuildTopScoresURL(const FLeaderboardQuery& Query) const;
+
+	//Query string of a top-scores URL, everything after the '?'. PinnedWindow adds explicit start and end times
+	static void AppendTopScoresParams(FStringBuilderBase& Builder, const FLeaderboardQuery& Query, int32 Limit, const TPair<FDateTime, FDateTime>* PinnedWindow = nullptr);
+
+	//Every top-scores body, single or pushed, ends up here. Pure, so it can be fed arbitrary input (see LeaderboardFuzz)
+	static bool ParseScores(FUtf8StringView Content, FScores& OutScores);
+	static bool ParseScores(FStringView Content, FScores& OutScores);
+
+	//UTC window of Period containing Time: days start at midnight, weeks on Monday, all_time spans everything
+	static FDateTime GetPeriodStart(ELeaderboardPeriod Period, const FDateTime& Time);
+	//Exclusive, i.e. the start of the next window. FDateTime::MaxValue for all_time
+	static FDateTime GetPeriodEnd(ELeaderboardPeriod Period, const FDateTime& Time);
+
+	UFUNCTION(BlueprintPure, Category= "LeaderboardController")
+	static void GetCurrentPeriodWindow(ELeaderboardPeriod Period, FDateTime& OutStart, FDateTime& OutEnd);
+
+	//Scheduling
+	UFUNCTION(BlueprintCallable, Category= "LeaderboardController")
+	bool CancelRequest(FLeaderboardRequestHandle Handle);
+
+	UFUNCTION(BlueprintCallable, Category= "LeaderboardController")
+	void SetMaxConcurrentRequests(int32 InMaxConcurrentRequests);
+
+	UFUNCTION(BlueprintCallable, Category= "LeaderboardController")
+	void SetScoreFilter(ELeaderboardScoreFilter InFilter) { NonImprovingScores = InFilter; }
+
+	FLeaderboardRequestScheduler& GetScheduler() { return Scheduler; }
+
+	//Profiles. Call with the usernames of the rows on screen; cached ones are returned right away, the rest are
+	//deduplicated, batched into ProfileBatchSize lookups on the next tick and announced through OnProfileResolved
+	UFUNCTION(BlueprintCallable, Category= "Profiles")
+	void ResolveProfiles(const TArray<FString>& Usernames);
+
+	UFUNCTION(BlueprintCallable, Category= "Profiles")
+	bool FindProfile(const FString& Username, FLeaderboardProfile& OutProfile);
+
+	FLeaderboardProfileCache& GetProfileCache() { return ProfileCache; }
+
+	//Shared budget over the board cache, profiles, queued request bodies and replicated name tables
+	FLeaderboardMemoryBudget& GetMemoryBudget() { return MemoryBudget; }
+
+	const TMap<FString, TObjectPtr<ULeaderboardSession>>& GetSessions() const { return Sessions; }
+	const TLeaderboardResponseCache<FScores>& GetTopScoresCache() const { return TopScoresCache; }
+
+	//In-game panel with queues, latencies, cache hit rates and token expiry. Also Mona.Leaderboard.Diagnostics 1.
+	//Does nothing in shipping builds
+	UFUNCTION(BlueprintCallable, Category= "Debug")
+	void SetDiagnosticsVisible(bool bVisible);
+
+	//Columnar board files (see FLeaderboardColumnarWriter) for analytics, also usable as offline snapshots
+	UFUNCTION(BlueprintCallable, Category= "Debug")
+	bool ExportScores(const FScores& Scores, const FString& Path);
+
+	UFUNCTION(BlueprintCallable, Category= "Debug")
+	bool ImportScores(const FString& Path, FScores& OutScores);
+
+	//Every board in the top-scores cache into one file, each block keyed by its request URL
+	//(FLeaderboardColumnarReader::LoadBoards). Also Mona.Leaderboard.Export <file>
+	UFUNCTION(BlueprintCallable, Category= "Debug")
+	bool ExportCachedScores(const FString& Path);
+
+	//Recording captures every request and response (secrets redacted) of whatever transport is active.
+	//Also started by -MonaRecord=<file>, which writes the file when the controller is destroyed
+	UFUNCTION(BlueprintCallable, Category= "Debug")
+	void StartRecording();
+
+	//Returns false if nothing was being recorded or the file could not be written
+	UFUNCTION(BlueprintCallable, Category= "Debug")
+	bool StopRecording(const FString& Path);
+
+	//Serves every request from a recording instead of the network, Speed times faster than recorded.
+	//Also started by -MonaReplay=<file> [-MonaReplaySpeed=<x>]
+	UFUNCTION(BlueprintCallable, Category= "Debug")
+	bool StartReplay(const FString& Path, float Speed = 1.f);
+
+	UFUNCTION(BlueprintCallable, Category= "Debug")
+	void StopReplay();
+
+	UFUNCTION(BlueprintPure, Category= "Debug")
+	bool IsReplaying() const { return ReplayTransport.IsValid(); }
+
+	//Application ID and signing secret as of now. Safe to call from any thread
+	std::shared_ptr<const FLeaderboardConfig> GetConfig() const { return Config.Load(); }
+
 	//Make sure App ID is set
 	bool ValidAppID() const;
 
-	bool ValidResponse(const FHttpResponsePtr& Response);
+	//200 and 304 (not modified) are valid. A 401 refreshes the given session's token, or the default session's
+	bool ValidResponse(const FLeaderboardHttpResponse& Response, ULeaderboardSession* Session = nullptr);
 
 	bool ValidAuthorization() const;
 
@@ -133,6 +391,9 @@ public:
 	UPROPERTY(BlueprintAssignable, Category= "LeaderboardController")
 	FOnTopScoresReceived OnTopScoresReceived;
 
+	UPROPERTY(BlueprintAssignable, Category= "LeaderboardController")
+	FOnTopScoresMultiReceived OnTopScoresMultiReceived;
+
 	UPROPERTY(BlueprintAssignable, Category= "LeaderboardController")
 	FOnOTPVerified OnOtpVerified;
 	
@@ -142,6 +403,25 @@ public:
 	UPROPERTY(BlueprintAssignable, Category= "LeaderboardController")
 	FOnScorePosted OnScorePosted;
 
+	//A score the default session did not send, see NonImprovingScores
+	UPROPERTY(BlueprintAssignable, Category= "LeaderboardController")
+	FOnScoreSkipped OnScoreSkipped;
+
+	UPROPERTY(BlueprintAssignable, Category= "Authorization")
+	FOnUserReceived OnUserReceived;
+
+	UPROPERTY(BlueprintAssignable, Category= "Profiles")
+	FOnProfileResolved OnProfileResolved;
+
+	//A daily/weekly/monthly board that was fetched recently has started over. Boards of the new
+	//period are already being prefetched, fetching them again now is cheap
+	UPROPERTY(BlueprintAssignable, Category= "LeaderboardController")
+	FOnLeaderboardPeriodRolledOver OnPeriodRolledOver;
+
+	//Rows that are new or whose score/rank moved since the previous live update
+	UPROPERTY(BlueprintAssignable, Category= "Live Leaderboard")
+	FOnLiveLeaderboardChanged OnLiveLeaderboardChanged;
+
 	static FString GenerateHmac(const FString& Message, const FString& Key);
 	
 protected:
@@ -155,26 +435,192 @@ protected:
 	UPROPERTY(BlueprintReadWrite, Category= "LeaderboardController")
 	int NumTopScoresToGet = 50;
 
+	//Root of every API call. Point at a local stand-in server for testing
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category= "LeaderboardController")
+	FString BaseURL = "https://api.monaverse.com";
+
+	//Push endpoint (ws:// or wss://) for live boards. Leave empty if the backend has none, live mode then polls
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "Live Leaderboard")
+	FString LiveLeaderboardStreamURL;
+
+	//Batch profile lookup, queried as <BaseURL><ProfilesPath>?usernames=a,b,c and answered with an array of profiles
+	//(or an object with an "items" array). The public API has no such endpoint, so by default profiles only come from
+	//the names on fetched boards. To enable, set this in the controller's class defaults once the backend (or a local
+	//stand-in BaseURL points at) serves it
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category= "Profiles")
+	FString ProfilesPath;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category= "Profiles")
+	int32 ProfileBatchSize = 50;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category= "Profiles")
+	int32 ProfileCacheBudgetKB = 256;
+
+	//Boards of one GetTopScoresMulti call requested at the same time, the rest wait for one of them to finish
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "LeaderboardController")
+	int32 MaxParallelMultiQueries = 3;
+
+	//Batch top-scores endpoint. When set, GetTopScoresMulti POSTs {"queries":["<query string>",...]} to
+	//<BaseURL><TopScoresBatchPath> and expects {"results":[<top scores>|null,...]} in the same order.
+	//Leave empty while the backend has none (or point BaseURL at a local stand-in), boards are then fetched one by one
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category= "LeaderboardController")
+	FString TopScoresBatchPath;
+
+	//Fill in starttime/endtime for the current UTC window of daily, weekly and monthly queries that leave them empty
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "LeaderboardController")
+	bool bDerivePeriodTimes = true;
+
+	//Seconds after a period boundary before its boards are prefetched, letting the server settle. Negative disables prefetching
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "LeaderboardController")
+	float RolloverPrefetchDelay = 2.f;
+
+	//Predictive prefetch. After each GetTopScores the views most often opened next from that one are fetched at
+	//Prefetch priority once the network is idle. 0 disables. Only active while FreshBoardMaxAge > 0
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "Prefetch")
+	int32 PrefetchViewCount = 2;
+
+	//Share of past moves from the current view that must have gone to a view before it is prefetched
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "Prefetch")
+	float PrefetchMinProbability = 0.25f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "Prefetch")
+	int32 PrefetchBudgetPerMinute = 6;
+
+	//GetTopScores shows a board fetched, revalidated or prefetched within this many seconds straight from cache,
+	//without a request. 0 (default) always asks the server and turns predictive prefetch off, as nothing prefetched
+	//would ever be shown. Posts through any session drop their topic's boards
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "Prefetch")
+	float FreshBoardMaxAge = 0.f;
+
+	//Personal bests are seeded from fetched boards (rows of a session's CurrentUser) and from the session's own posts.
+	//Demote and Skip are opt-in: the server still stores every post, only best-per-player boards ignore non-improving ones
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "LeaderboardController")
+	ELeaderboardScoreFilter NonImprovingScores = ELeaderboardScoreFilter::PostAll;
+
+	//Everything the plugin caches together stays under this, see Mona.Leaderboard.Memory
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category= "LeaderboardController")
+	int32 MemoryBudgetKB = 4096;
+
+	virtual void PostInitProperties() override;
 	virtual void FinishDestroy() override;
 
 	UFUNCTION(BlueprintCallable, Category= "Authorization")
 	void GetUser(const FString& BearerToken);
 
+	//Cancel a pending GetTopScores when a newer one is requested, so stale boards are never broadcast
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "LeaderboardController")
+	bool bCancelSupersededTopScores = true;
+
+	//Errors are also listed in the diagnostics panel while it is shown, see SetDiagnosticsVisible
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "Debug")
 	bool bShowDebug = true;
 private:
+	friend class ULeaderboardSession;
+
 	static ULeaderboardController* Instance;
 
+	UPROPERTY(Transient)
+	TObjectPtr<ULeaderboardSession> DefaultSession;
+
+	UPROPERTY(Transient)
+	TMap<FString, TObjectPtr<ULeaderboardSession>> Sessions;
+
+	//bConditional sends the cached board's validators
+	FLeaderboardRequestHandle SubmitTopScores(const FLeaderboardQuery& Query, FOnTopScoresComplete OnComplete, ELeaderboardRequestPriority Priority, bool bConditional);
+
 	//Response Callbacks
-	void TopScoresResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully);
-	void ClientPostScoreResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully);
-	void GenerateOTPResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully);
-	void VerifyOTPResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully);
-	void GetUserResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully);
-	void RefreshAccessTokenResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully);
-
-	FString AccessToken;
-	FString RefreshToken;
-	std::mutex Mutex;
+	void TopScoresResponseReceived(const FLeaderboardHttpResponse& Response, FLeaderboardQuery Query, ELeaderboardRequestPriority Priority, bool bConditional, FOnTopScoresComplete OnComplete);
+	void LivePollResponseReceived(const FLeaderboardHttpResponse& Response);
+	void ProfilesResponseReceived(const FLeaderboardHttpResponse& Response, TArray<FString> Requested);
+	void TopScoresBatchResponseReceived(const FLeaderboardHttpResponse& Response, TSharedRef<FLeaderboardMultiFetch> Fetch);
+
+	//bPinWindow adds the current window's times to rolling queries, see bDerivePeriodTimes
+	void AppendTopScoresQuery(FStringBuilderBase& Builder, const FLeaderboardQuery& Query, bool bPinWindow = true) const;
+	static bool ParseScores(const TSharedRef<FJsonObject>& Object, FScores& OutScores);
+
+	//Period rollover. Recently fetched period queries are prefetched once their window has rolled over
+	static bool IsRollingQuery(const FLeaderboardQuery& Query);
+	static double GetRolloverTimeToLive(const FLeaderboardQuery& Query);
+	void TrackRolloverQuery(const FLeaderboardQuery& Query);
+	void ScheduleRollover();
+	bool HandleRollover(float DeltaTime);
+	TArray<FLeaderboardQuery> RolloverQueries;
+	FDateTime NextRollover;
+	FTSTicker::FDelegateHandle RolloverHandle;
+
+	//Predictive prefetch, fed by GetTopScores (the UI path) only
+	static FString GetViewKey(const FLeaderboardQuery& Query);
+	const TLeaderboardResponseCache<FScores>::FEntry* FindFreshBoard(const FString& URL) const;
+	//After a post to Topic landed, none of its cached boards can be shown as fresh
+	void InvalidateTopic(const FString& Topic);
+	void SchedulePrefetch(const FLeaderboardQuery& From);
+	bool TickPrefetch(float DeltaTime);
+	TLeaderboardNavigationModel<FLeaderboardQuery> NavigationModel;
+	TArray<FLeaderboardQuery> PrefetchCandidates;
+	//Dispatch times within the last minute, for PrefetchBudgetPerMinute
+	TArray<double> PrefetchTimes;
+	TMap<FString, FLeaderboardRequestHandle> PrefetchesInFlight;
+	//URL of the board on screen, and of a prefetch it is waiting on instead of its own request
+	FString ViewURL;
+	FString PrefetchAwaitedURL;
+	FTSTicker::FDelegateHandle PrefetchHandle;
+
+	//Multi fetch
+	void LaunchNextMultiQuery(const TSharedRef<FLeaderboardMultiFetch>& Fetch);
+	void FinishMultiFetch(const TSharedRef<FLeaderboardMultiFetch>& Fetch);
+
+	//Live leaderboard
+	bool TickLiveLeaderboard(float DeltaTime);
+	void PollLiveLeaderboard();
+	void ConnectLiveStream();
+	void LiveStreamMessageReceived(const FString& Message);
+	void LiveStreamFailed();
+	bool ApplyLiveBoard(const FScores& Board);
+
+	FLeaderboardRequestScheduler Scheduler;
+	FLeaderboardRequestHandle TopScoresHandle;
+
+	//Signing secret and record/replay switches
+	void ApplyCommandLine();
+
+	//Republishes ApplicationID and SDKSecret for GetConfig after either changed
+	void PublishConfig();
+	TLeaderboardSnapshot<FLeaderboardConfig> Config;
+	TSharedPtr<FLeaderboardRecordingTransport> RecordingTransport;
+	TSharedPtr<FLeaderboardReplayTransport> ReplayTransport;
+	FString CommandLineRecordingPath;
+
+	//Per-endpoint verb, URL and constant headers, rebuilt when the base URL or application ID changes
+	FLeaderboardRequestTemplates RequestTemplates;
+
+	FLeaderboardMemoryBudget MemoryBudget;
+
+	//Conditional GET cache, keyed by request URL
+	TLeaderboardResponseCache<FScores> TopScoresCache{TEXT("Top scores")};
+
+	//Profiles
+	bool FlushProfileQueue(float DeltaTime);
+	void StoreProfilesFromBoard(const FScores& Board);
+
+	//Personal bests of every session whose user is on the board
+	void SeedPersonalBests(const FLeaderboardQuery& Query, const FScores& Board);
+	FLeaderboardProfileCache ProfileCache;
+	TArray<FString> ProfileQueue;
+	//Queued or in flight, so a username is never asked for twice at once
+	TSet<FString> ProfilesPending;
+	FTSTicker::FDelegateHandle ProfileFlushHandle;
+
+	bool bLiveActive = false;
+	bool bHasLiveBoard = false;
+	bool bLiveStreamFailed = false;
+	FLeaderboardQuery LiveQuery;
+	FScores LiveBoard;
+	float LiveMinPollInterval = 2.f;
+	float LiveMaxPollInterval = 30.f;
+	float LivePollInterval = 2.f;
+	double LiveNextPollTime = 0.0;
+	FLeaderboardRequestHandle LivePollHandle;
+	TSharedPtr<IWebSocket> LiveSocket;
+	FTSTicker::FDelegateHandle LiveTickerHandle;
 	
 };
@@ -0,0 +1,280 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <coroutine>
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "LeaderboardController.h"
+#include "LeaderboardSession.h"
+
+/**
+ * C++20 coroutine front end for the controller and session calls.
+ *
+ * Every MonaLeaderboard:: call starts its request immediately and returns an awaitable operation,
+ * so independent requests overlap simply by starting them before awaiting them:
+ *
+ *	FLeaderboardCoroutine PostAndRefresh(ULeaderboardSession* Session, FLeaderboardQuery AroundMe, FLeaderboardQuery Top)
+ *	{
+ *		if (!co_await MonaLeaderboard::PostScore(Session, 1200.f, TEXT("race"))) co_return;
+ *		auto AroundMeOp = MonaLeaderboard::GetTopScores(AroundMe);
+ *		auto TopOp = MonaLeaderboard::GetTopScores(Top);
+ *		TOptional<FScores> AroundMeScores = co_await AroundMeOp;
+ *		TOptional<FScores> TopScores = co_await TopOp;
+ *	}
+ *
+ * Operations resolve to their failure value (false / unset optional) on error, timeout or cancellation,
+ * including requests the scheduler drops without completing them (those resume on the next tick).
+ * Everything runs and resumes on the game thread.
+ */
+
+//Cooperative cancellation shared between the code that cancels and the operations it covers
+class FLeaderboardCancellationToken
+{
+public:
+	FLeaderboardCancellationToken()
+		: State(MakeShared<FState>())
+	{
+	}
+
+	void Cancel() const
+	{
+		if (State->bCancelled) return;
+		State->bCancelled = true;
+		TArray<TFunction<void()>> Callbacks = MoveTemp(State->Callbacks);
+		State->Callbacks.Reset();
+		for (TFunction<void()>& Callback : Callbacks)
+		{
+			Callback();
+		}
+	}
+
+	bool IsCancelled() const { return State->bCancelled; }
+
+	//Runs immediately if already cancelled
+	void OnCancelled(TFunction<void()> Callback) const
+	{
+		if (State->bCancelled)
+		{
+			Callback();
+			return;
+		}
+		State->Callbacks.Add(MoveTemp(Callback));
+	}
+
+private:
+	struct FState
+	{
+		bool bCancelled = false;
+		TArray<TFunction<void()>> Callbacks;
+	};
+
+	TSharedRef<FState> State;
+};
+
+struct FLeaderboardAwaitOptions
+{
+	//0 means no timeout
+	float TimeoutSeconds = 0.f;
+
+	TOptional<FLeaderboardCancellationToken> CancellationToken;
+};
+
+//Awaitable handle to a request that is already in flight
+template<typename ResultType>
+class TLeaderboardOperation
+{
+public:
+	struct FState
+	{
+		TOptional<ResultType> Result;
+		std::coroutine_handle<> Continuation;
+		TWeakObjectPtr<ULeaderboardController> Controller;
+		FLeaderboardRequestHandle Handle;
+		FTSTicker::FDelegateHandle TimeoutHandle;
+
+		void Complete(ResultType Value)
+		{
+			if (Result.IsSet()) return;
+			Result = MoveTemp(Value);
+			if (TimeoutHandle.IsValid())
+			{
+				FTSTicker::GetCoreTicker().RemoveTicker(TimeoutHandle);
+				TimeoutHandle.Reset();
+			}
+			if (Continuation)
+			{
+				std::coroutine_handle<> Resume = Continuation;
+				Continuation = nullptr;
+				Resume.resume();
+			}
+		}
+
+		//Stops the request if it can still be stopped and resolves to the failure value
+		void Abort()
+		{
+			if (Result.IsSet()) return;
+			if (ULeaderboardController* Owner = Controller.Get())
+			{
+				Owner->CancelRequest(Handle);
+			}
+			Complete(ResultType());
+		}
+	};
+
+	explicit TLeaderboardOperation(TSharedRef<FState> InState)
+		: State(MoveTemp(InState))
+	{
+	}
+
+	bool IsDone() const { return State->Result.IsSet(); }
+	void Cancel() const { State->Abort(); }
+
+	bool await_ready() const { return State->Result.IsSet(); }
+	void await_suspend(std::coroutine_handle<> Handle) const { State->Continuation = Handle; }
+	ResultType await_resume() const { return State->Result.GetValue(); }
+
+private:
+	TSharedRef<FState> State;
+};
+
+//Fire-and-forget coroutine return type. Runs eagerly until its first suspension and frees itself when done
+struct FLeaderboardCoroutine
+{
+	struct promise_type
+	{
+		FLeaderboardCoroutine get_return_object() { return FLeaderboardCoroutine(); }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { checkNoEntry(); }
+	};
+};
+
+namespace MonaLeaderboard
+{
+	namespace Private
+	{
+		//Shared by every copy of an operation's completion callback. If the last copy is dropped without running
+		//(e.g. CancelAll) the operation resolves to its failure value, like TLeaderboardPromise, so the awaiting
+		//coroutine still resumes and its frame is freed. That happens on the next tick: the copy is dropped while
+		//the scheduler is still removing it from its queues (or during GC), and a resumed coroutine may submit again
+		template<typename ResultType>
+		struct TCompletionGuard
+		{
+			using FState = typename TLeaderboardOperation<ResultType>::FState;
+
+			explicit TCompletionGuard(TSharedRef<FState> InState)
+				: State(MoveTemp(InState))
+			{
+			}
+
+			~TCompletionGuard()
+			{
+				if (State->Result.IsSet()) return;
+				FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([State = State](float)
+				{
+					State->Complete(ResultType());
+					return false;
+				}));
+			}
+
+			TSharedRef<FState> State;
+		};
+
+		//Launch receives the completion callback and returns the scheduler handle, if the call has one
+		template<typename ResultType, typename LaunchType>
+		TLeaderboardOperation<ResultType> Start(ULeaderboardController* Controller, const FLeaderboardAwaitOptions& Options, LaunchType&& Launch)
+		{
+			using FState = typename TLeaderboardOperation<ResultType>::FState;
+			TSharedRef<FState> State = MakeShared<FState>();
+			State->Controller = Controller;
+			TWeakPtr<FState> WeakState = State;
+			if (Options.TimeoutSeconds > 0.f)
+			{
+				State->TimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakState](float)
+				{
+					if (TSharedPtr<FState> Pinned = WeakState.Pin())
+					{
+						Pinned->TimeoutHandle.Reset();
+						Pinned->Abort();
+					}
+					return false;
+				}), Options.TimeoutSeconds);
+			}
+			if (Options.CancellationToken.IsSet())
+			{
+				Options.CancellationToken->OnCancelled([WeakState]()
+				{
+					if (TSharedPtr<FState> Pinned = WeakState.Pin())
+					{
+						Pinned->Abort();
+					}
+				});
+			}
+			TSharedRef<TCompletionGuard<ResultType>> Guard = MakeShared<TCompletionGuard<ResultType>>(State);
+			State->Handle = Launch([Guard](ResultType Value) { Guard->State->Complete(MoveTemp(Value)); });
+			return TLeaderboardOperation<ResultType>(State);
+		}
+
+		inline ULeaderboardSession* ResolveSession(ULeaderboardSession* Session)
+		{
+			return Session ? Session : ULeaderboardController::GetLeaderboardController()->GetDefaultSession();
+		}
+	}
+
+	inline TLeaderboardOperation<TOptional<FScores>> GetTopScores(const FLeaderboardQuery& Query, const FLeaderboardAwaitOptions& Options = FLeaderboardAwaitOptions())
+	{
+		ULeaderboardController* Controller = ULeaderboardController::GetLeaderboardController();
+		return Private::Start<TOptional<FScores>>(Controller, Options, [Controller, Query](TFunction<void(TOptional<FScores>)> Done)
+		{
+			return Controller->GetTopScoresAsync(Query, [Done = MoveTemp(Done)](bool bSuccess, const FScores& Scores)
+			{
+				Done(bSuccess ? TOptional<FScores>(Scores) : TOptional<FScores>());
+			});
+		});
+	}
+
+	inline TLeaderboardOperation<bool> GenerateOTP(ULeaderboardSession* Session, const FString& Email, const FLeaderboardAwaitOptions& Options = FLeaderboardAwaitOptions())
+	{
+		Session = Private::ResolveSession(Session);
+		return Private::Start<bool>(nullptr, Options, [Session, Email](TFunction<void(bool)> Done)
+		{
+			Session->GenerateOTPAsync(Email, MoveTemp(Done));
+			return FLeaderboardRequestHandle();
+		});
+	}
+
+	inline TLeaderboardOperation<bool> VerifyOTP(ULeaderboardSession* Session, const FString& Email, const FString& OTP, const FLeaderboardAwaitOptions& Options = FLeaderboardAwaitOptions())
+	{
+		Session = Private::ResolveSession(Session);
+		return Private::Start<bool>(nullptr, Options, [Session, Email, OTP](TFunction<void(bool)> Done)
+		{
+			Session->VerifyOTPAsync(Email, OTP, MoveTemp(Done));
+			return FLeaderboardRequestHandle();
+		});
+	}
+
+	inline TLeaderboardOperation<bool> PostScore(ULeaderboardSession* Session, const float Score, const FString& Topic, const FLeaderboardAwaitOptions& Options = FLeaderboardAwaitOptions())
+	{
+		Session = Private::ResolveSession(Session);
+		return Private::Start<bool>(nullptr, Options, [Session, Score, Topic](TFunction<void(bool)> Done)
+		{
+			Session->PostScoreAsync(Score, Topic, MoveTemp(Done));
+			return FLeaderboardRequestHandle();
+		});
+	}
+
+	inline TLeaderboardOperation<TOptional<FUser>> GetUser(ULeaderboardSession* Session, const FLeaderboardAwaitOptions& Options = FLeaderboardAwaitOptions())
+	{
+		Session = Private::ResolveSession(Session);
+		return Private::Start<TOptional<FUser>>(nullptr, Options, [Session](TFunction<void(TOptional<FUser>)> Done)
+		{
+			Session->GetUserAsync([Done = MoveTemp(Done)](bool bSuccess, const FUser& User)
+			{
+				Done(bSuccess ? TOptional<FUser>(User) : TOptional<FUser>());
+			});
+			return FLeaderboardRequestHandle();
+		});
+	}
+}
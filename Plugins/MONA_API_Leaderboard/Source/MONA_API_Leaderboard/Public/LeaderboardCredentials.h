@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "CoreMinimal.h"
+
+//One session's tokens. Never edited in place: a login or refresh publishes a new snapshot
+struct FLeaderboardCredentials
+{
+	FString AccessToken;
+	FString RefreshToken;
+	//"Bearer <AccessToken>", built once per snapshot
+	FString AuthorizationHeader;
+
+	bool IsAuthorized() const { return !AccessToken.IsEmpty() && !RefreshToken.IsEmpty(); }
+
+	void SetAccessToken(const FString& InAccessToken)
+	{
+		AccessToken = InAccessToken;
+		AuthorizationHeader = TEXT("Bearer ") + AccessToken;
+	}
+};
+
+//Controller settings that request building and signing read, possibly off the game thread
+struct FLeaderboardConfig
+{
+	FString ApplicationID;
+	FString SDKSecret;
+};
+
+/**
+ * An immutable T that any thread can read while another publishes. Writers publish a whole replacement; a reader
+ * keeps the snapshot it loaded alive for as long as it holds the pointer, so values never tear. Not lock-free: MSVC's
+ * and libstdc++'s atomic shared_ptr (and the atomic_load fallback) guard the pointer swap with a small lock, so a
+ * load may wait out a concurrent store. Only the refcount update is held under it, never building or copying a T.
+ */
+template<typename T>
+class TLeaderboardSnapshot
+{
+public:
+	TLeaderboardSnapshot() : Value(std::make_shared<const T>()) {}
+
+	TLeaderboardSnapshot(const TLeaderboardSnapshot&) = delete;
+	TLeaderboardSnapshot& operator=(const TLeaderboardSnapshot&) = delete;
+
+	std::shared_ptr<const T> Load() const
+	{
+#if defined(__cpp_lib_atomic_shared_ptr)
+		return Value.load(std::memory_order_acquire);
+#else
+		PRAGMA_DISABLE_DEPRECATION_WARNINGS
+		return std::atomic_load_explicit(&Value, std::memory_order_acquire);
+		PRAGMA_ENABLE_DEPRECATION_WARNINGS
+#endif
+	}
+
+	void Store(T&& NewValue)
+	{
+		std::shared_ptr<const T> Desired = std::make_shared<const T>(MoveTemp(NewValue));
+#if defined(__cpp_lib_atomic_shared_ptr)
+		Value.store(MoveTemp(Desired), std::memory_order_release);
+#else
+		PRAGMA_DISABLE_DEPRECATION_WARNINGS
+		std::atomic_store_explicit(&Value, MoveTemp(Desired), std::memory_order_release);
+		PRAGMA_ENABLE_DEPRECATION_WARNINGS
+#endif
+	}
+
+	//Copy, modify, publish. Concurrent updates retry rather than overwrite each other
+	template<typename FuncType>
+	void Update(FuncType&& Modify)
+	{
+		std::shared_ptr<const T> Expected = Load();
+		for (;;)
+		{
+			T Copy = *Expected;
+			Modify(Copy);
+			std::shared_ptr<const T> Desired = std::make_shared<const T>(MoveTemp(Copy));
+#if defined(__cpp_lib_atomic_shared_ptr)
+			if (Value.compare_exchange_weak(Expected, MoveTemp(Desired), std::memory_order_acq_rel, std::memory_order_acquire)) return;
+#else
+			PRAGMA_DISABLE_DEPRECATION_WARNINGS
+			if (std::atomic_compare_exchange_weak_explicit(&Value, &Expected, MoveTemp(Desired), std::memory_order_acq_rel, std::memory_order_acquire)) return;
+			PRAGMA_ENABLE_DEPRECATION_WARNINGS
+#endif
+		}
+	}
+
+private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+	std::atomic<std::shared_ptr<const T>> Value;
+#else
+	//Standard libraries without atomic<shared_ptr> still have the free atomic functions for it
+	std::shared_ptr<const T> Value;
+#endif
+};
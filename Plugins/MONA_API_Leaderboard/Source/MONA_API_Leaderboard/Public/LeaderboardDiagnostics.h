@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//The panel and its message list only exist outside shipping. Define to 0 to strip them from other builds too
+#ifndef WITH_LEADERBOARD_DIAGNOSTICS
+#define WITH_LEADERBOARD_DIAGNOSTICS !UE_BUILD_SHIPPING
+#endif
+
+#if WITH_LEADERBOARD_DIAGNOSTICS
+
+class UCanvas;
+class APlayerController;
+
+/**
+ * In-game leaderboard diagnostics: queue depth per priority, in-flight requests, per-endpoint last latency,
+ * cache hit rates, memory use, token expiry per session and recent errors, each on its own line.
+ * The draw callback is only registered with UDebugDrawService while the panel is shown, and callers check
+ * IsVisible before formatting a message, so a hidden panel costs nothing. Game thread only.
+ * Toggle with Mona.Leaderboard.Diagnostics 0/1.
+ */
+class MONA_API_LEADERBOARD_API FLeaderboardDiagnostics
+{
+public:
+	static void SetVisible(bool bVisible);
+	static bool IsVisible() { return DrawHandle.IsValid(); }
+
+	//Shown under the stats for DisplaySeconds. The oldest message goes once MaxMessages are shown
+	static void AddMessage(FString&& Message, const FColor& Color = FColor::Red, float DisplaySeconds = 5.f);
+
+private:
+	static void Draw(UCanvas* Canvas, APlayerController* PlayerController);
+
+	struct FMessage
+	{
+		FString Text;
+		FColor Color;
+		double ExpiresTime = 0.0;
+	};
+
+	static constexpr int32 MaxMessages = 8;
+	static TArray<FMessage> Messages;
+	static FDelegateHandle DrawHandle;
+};
+
+#endif
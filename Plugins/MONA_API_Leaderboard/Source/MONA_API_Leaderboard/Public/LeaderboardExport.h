@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeaderboardController.h"
+
+/**
+ * Columnar board file ("MLBC") for analytics exports and offline snapshots. After a small header the rows come in
+ * blocks of up to RowsPerBlock. Each block starts with the key of the board it belongs to (the request URL for cached
+ * boards, so period, order, featured and window survive) and holds its own string dictionary (usernames, names,
+ * topics) followed by one column per field; IDs, ranks, scores and Created_At (Unix milliseconds) are zigzag varints,
+ * delta-encoded against the previous row. A block with zero rows ends the file. Readers only ever hold one block,
+ * whatever the file size.
+ */
+class MONA_API_LEADERBOARD_API FLeaderboardColumnarWriter
+{
+public:
+	static constexpr int32 DefaultRowsPerBlock = 4096;
+
+	explicit FLeaderboardColumnarWriter(int32 InRowsPerBlock = DefaultRowsPerBlock);
+	~FLeaderboardColumnarWriter();
+
+	FLeaderboardColumnarWriter(const FLeaderboardColumnarWriter&) = delete;
+	FLeaderboardColumnarWriter& operator=(const FLeaderboardColumnarWriter&) = delete;
+
+	bool Open(const FString& Path);
+	//Rows added from now on belong to the board Key. Ends the current block, a block never mixes boards
+	void BeginBoard(const FString& Key);
+	void Add(const FUserInfo& Row);
+	void Add(const FScores& Scores);
+	//Writes the last block and the end marker. False if anything failed to write
+	bool Close();
+
+	int64 GetNumRows() const { return NumRows; }
+
+	//One block's payload, exposed so it can be produced and checked without a file
+	static void EncodeBlock(TArrayView<const FUserInfo> Rows, TArray<uint8>& OutPayload);
+
+private:
+	void FlushBlock();
+
+	TUniquePtr<FArchive> Archive;
+	TArray<FUserInfo> Pending;
+	TArray<uint8> Payload;
+	FString BoardKey;
+	int32 RowsPerBlock;
+	int64 NumRows = 0;
+};
+
+class MONA_API_LEADERBOARD_API FLeaderboardColumnarReader
+{
+public:
+	//A corrupt header must not make the reader allocate gigabytes
+	static constexpr int32 MaxRowsPerBlock = 1 << 20;
+	static constexpr int32 MaxBlockBytes = 64 * 1024 * 1024;
+
+	bool Open(const FString& Path);
+
+	//Replaces OutRows with the next block. False at the end of the file or on error, see HasError
+	bool ReadBlock(TArray<FUserInfo>& OutRows);
+
+	bool HasError() const { return bError; }
+
+	//Board key of the block ReadBlock returned last
+	const FString& GetBoardKey() const { return BoardKey; }
+
+	//Whole file into one board, for snapshots small enough to keep in memory
+	static bool LoadFile(const FString& Path, FScores& OutScores);
+
+	//Whole file, one board per key
+	static bool LoadBoards(const FString& Path, TMap<FString, FScores>& OutBoards);
+
+	//Inverse of FLeaderboardColumnarWriter::EncodeBlock. False if the payload is malformed
+	static bool DecodeBlock(TArrayView<const uint8> Payload, int32 NumRows, TArray<FUserInfo>& OutRows);
+
+private:
+	TUniquePtr<FArchive> Archive;
+	TArray<uint8> Payload;
+	FString BoardKey;
+	bool bError = false;
+	bool bEnded = false;
+};
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LeaderboardFuzzCommandlet.generated.h"
+
+/**
+ * Fuzz and stress harness for everything that decodes untrusted bytes: top-scores bodies, VerifyOTP / refresh token
+ * bodies, user bodies, columnar board blocks, and GenerateHmac. Inputs are built-in seeds plus the files under -Corpus,
+ * mutated libFuzzer style (bit flips, byte edits, truncation, splicing, repeated chunks, deep nesting), after a fixed
+ * set of oversized and deeply nested stress inputs.
+ * Each input gets a time and memory allowance; memory is the peak of live heap bytes while it ran, counted at the
+ * allocator (FLeaderboardAllocationCounter). Inputs that exceed one or break a round-trip check are written to
+ * -Artifacts, as is the input that was running if the process crashes; -Input=<file> replays a single one.
+ * An input still running after -Timeout seconds is a hang: a watchdog thread saves it and aborts the run, like
+ * libFuzzer's -timeout.
+ *
+ *   UnrealEditor-Cmd <Project> -run=LeaderboardFuzz [-Target=All|TopScores|Tokens|User|Columnar|Hmac]
+ *     [-Corpus=<dir>] [-Artifacts=<dir>] [-Iterations=100000] [-Duration=0] [-Seed=0] [-MaxLen=65536]
+ *     [-TimeLimitMs=50] [-MsPerMB=250] [-MemoryLimitMB=64] [-Timeout=10] [-Input=<file>]
+ *
+ * Returns 1 if any input failed.
+ */
+UCLASS()
+class MONA_API_LEADERBOARD_API ULeaderboardFuzzCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	ULeaderboardFuzzCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	enum class ETarget : uint8
+	{
+		TopScores,
+		Tokens,
+		User,
+		Columnar,
+		Hmac,
+		Count
+	};
+
+	struct FTargetStats
+	{
+		int32 NumInputs = 0;
+		int32 NumAccepted = 0;
+		int32 NumFailed = 0;
+		double TotalSeconds = 0.0;
+		double MaxSeconds = 0.0;
+	};
+
+	static const TCHAR* GetTargetName(ETarget Target);
+
+	//False if the decoder broke one of its own invariants
+	static bool RunTarget(ETarget Target, TArrayView<const uint8> Input, bool& bOutAccepted);
+
+	static void AddSeeds(ETarget Target, TArray<TArray<uint8>>& OutSeeds);
+	static void AddStressInputs(ETarget Target, TArray<TArray<uint8>>& OutInputs);
+	void Mutate(TArray<uint8>& Input, const TArray<TArray<uint8>>& Pool);
+
+	//Runs one input under the time and memory limits, saving it on failure
+	void Execute(ETarget Target, const TArray<uint8>& Input);
+	void SaveArtifact(ETarget Target, const TCHAR* Reason, const TArray<uint8>& Input);
+	void HandleCrash();
+	//Watchdog thread body, runs until StopWatchdog is triggered
+	void Watchdog();
+	bool Report() const;
+
+	FTargetStats Stats[static_cast<int32>(ETarget::Count)];
+	FRandomStream Random;
+	FString ArtifactsDir;
+	int32 MaxLen = 64 * 1024;
+	double TimeLimitMs = 50.0;
+	double MsPerMB = 250.0;
+	int64 MemoryLimitBytes = 64 * 1024 * 1024;
+	int32 NumArtifacts = 0;
+
+	double TimeoutSeconds = 10.0;
+
+	//Input being decoded, written out if the process crashes or hangs. The watchdog reads these under CurrentInputLock
+	const TArray<uint8>* CurrentInput = nullptr;
+	ETarget CurrentTarget = ETarget::Count;
+	double CurrentInputStartTime = 0.0;
+	FCriticalSection CurrentInputLock;
+	FEvent* StopWatchdog = nullptr;
+};
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+class FJsonValue;
+
+//Every response body goes through these before it reaches FJsonSerializer
+namespace LeaderboardJson
+{
+	//Bodies beyond this are refused unparsed, whatever the endpoint
+	constexpr int32 MaxResponseBytes = 16 * 1024 * 1024;
+	//Freeing a parsed tree recurses once per level, so deeper documents are refused before parsing
+	constexpr int32 MaxDepth = 64;
+
+	//False for malformed JSON, more than MaxBytes or more than MaxDepth levels
+	MONA_API_LEADERBOARD_API bool Parse(FUtf8StringView Content, TSharedPtr<FJsonValue>& OutValue, int32 MaxBytes = MaxResponseBytes);
+	MONA_API_LEADERBOARD_API bool Parse(FUtf8StringView Content, TSharedPtr<FJsonObject>& OutObject, int32 MaxBytes = MaxResponseBytes);
+}
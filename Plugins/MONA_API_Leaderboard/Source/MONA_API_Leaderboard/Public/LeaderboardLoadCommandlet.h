@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LeaderboardRequestTemplates.h"
+#include "LeaderboardLoadCommandlet.generated.h"
+
+class ULeaderboardSession;
+struct FLeaderboardHttpResponse;
+
+/**
+ * Headless load generator. Drives N virtual players through OTP login, then score posts and top-score reads with
+ * random think times, all through the regular controller (request templates, signing, scheduler, parsing).
+ *
+ *   UnrealEditor-Cmd <Project> -run=LeaderboardLoad -AppID=<id> -MonaSDKSecret=<secret> [-BaseURL=<url>]
+ *     [-Users=100] [-Duration=60] [-RampUp=10] [-ThinkMin=1] [-ThinkMax=5] [-ReadRatio=0.7] [-Topic=<topic>]
+ *     [-Email=loadtest+{0}@example.com] [-OTP=000000] [-Concurrency=<Users>] [-MaxErrorRate=0.01]
+ *
+ * For a local mock point -BaseURL at a stand-in server, or serve a recording with -MonaReplay=<file> -MonaReplaySpeed=0.
+ * Prints throughput and error rates per operation, then per endpoint the server latency (dispatch to response) and,
+ * separately, the time requests waited in the client's queue for one of the Concurrency slots. Concurrency defaults
+ * to Users so the queue stays empty and latency is the server's. Returns 1 if the error rate exceeds MaxErrorRate.
+ */
+UCLASS()
+class MONA_API_LEADERBOARD_API ULeaderboardLoadCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	ULeaderboardLoadCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	enum class EOperation : uint8
+	{
+		GenerateOTP,
+		VerifyOTP,
+		PostScore,
+		TopScores,
+		Count
+	};
+
+	struct FVirtualUser
+	{
+		TWeakObjectPtr<ULeaderboardSession> Session;
+		FString Email;
+		double NextActionTime = 0.0;
+		bool bBusy = false;
+		bool bOtpSent = false;
+		bool bLoggedIn = false;
+	};
+
+	struct FOperationStats
+	{
+		int32 NumOperations = 0;
+		int32 NumErrors = 0;
+	};
+
+	struct FRequestStats
+	{
+		TArray<double> ServerLatencies;
+		TArray<double> QueueSeconds;
+	};
+
+	static const TCHAR* GetOperationName(EOperation Operation);
+
+	void StartNextAction(int32 UserIndex);
+	void Finish(int32 UserIndex, EOperation Operation, bool bSuccess);
+	void RecordResponse(ELeaderboardEndpoint Endpoint, const FLeaderboardHttpResponse& Response, double QueueSeconds);
+	//Percentile of sorted seconds, in milliseconds
+	static double GetPercentile(const TArray<double>& Sorted, double Percentile);
+	bool Report(double ElapsedSeconds);
+
+	TArray<FVirtualUser> Users;
+	FOperationStats Stats[static_cast<int32>(EOperation::Count)];
+	FRequestStats RequestStats[static_cast<int32>(ELeaderboardEndpoint::Count)];
+
+	FString Topic;
+	FString OTP = TEXT("000000");
+	float ThinkMin = 1.f;
+	float ThinkMax = 5.f;
+	float ReadRatio = 0.7f;
+	float MaxErrorRate = 0.01f;
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FLeaderboardMemoryBudget;
+
+/**
+ * Something holding leaderboard memory: a cache, an intern table, queued request bodies.
+ * Pools that can drop entries offer their best eviction candidate; the budget decides across pools.
+ */
+class MONA_API_LEADERBOARD_API ILeaderboardMemoryPool
+{
+public:
+	ILeaderboardMemoryPool() = default;
+	//A copy starts out unregistered
+	ILeaderboardMemoryPool(const ILeaderboardMemoryPool&) {}
+	ILeaderboardMemoryPool& operator=(const ILeaderboardMemoryPool&) { return *this; }
+	virtual ~ILeaderboardMemoryPool();
+
+	virtual const TCHAR* GetPoolName() const = 0;
+	virtual int64 GetUsedBytes() const = 0;
+
+	//Score of the entry this pool would rather lose, see FLeaderboardMemoryBudget. False if nothing can go
+	virtual bool GetEvictionCandidate(double& OutScore) const { return false; }
+	//Drops that entry
+	virtual void EvictCandidate() {}
+
+protected:
+	//Pools call this after they grew
+	void NotifyGrew();
+
+	//Higher scores are evicted first: big entries that are cheap to fetch again and have not been used for a while
+	static double ScoreEntry(int64 Bytes, double RefetchCost, double LastUsedTime);
+
+private:
+	friend class FLeaderboardMemoryBudget;
+	FLeaderboardMemoryBudget* Budget = nullptr;
+};
+
+/**
+ * One byte budget shared by every registered pool. When the total goes over it, entries are evicted across pools
+ * by score (size x idle time / refetch cost) until it fits again. Game thread only.
+ */
+class MONA_API_LEADERBOARD_API FLeaderboardMemoryBudget
+{
+public:
+	~FLeaderboardMemoryBudget();
+
+	void Register(ILeaderboardMemoryPool& Pool);
+	void Unregister(ILeaderboardMemoryPool& Pool);
+
+	void SetBudgetBytes(int64 InBudgetBytes);
+	int64 GetBudgetBytes() const { return BudgetBytes; }
+	int64 GetUsedBytes() const;
+
+	void Enforce();
+	void Dump() const;
+
+private:
+	TArray<ILeaderboardMemoryPool*> Pools;
+	int64 BudgetBytes = 4 * 1024 * 1024;
+	bool bEnforcing = false;
+};
@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * First-order Markov model of how a player moves between views (e.g. board tabs), keyed by a caller-chosen string.
+ * Counts how often each view followed another, so the likeliest next views can be fetched ahead of time.
+ * A view's counts are halved once their total passes MaxTotal, which lets new habits take over from old ones.
+ * At most MaxViews source views with MaxSuccessors each are kept; the least recently visited view goes first.
+ * Game thread only.
+ */
+template<typename ViewType>
+class TLeaderboardNavigationModel
+{
+public:
+	static constexpr int32 MaxViews = 32;
+	static constexpr int32 MaxSuccessors = 8;
+	static constexpr float MaxTotal = 64.f;
+
+	//Counts the move from the previously recorded view, if it was a different one
+	void Record(const FString& Key, const ViewType& View)
+	{
+		if (!PreviousKey.IsEmpty() && PreviousKey != Key)
+		{
+			FSource& Source = FindOrAddSource(PreviousKey);
+			FSuccessor* Successor = Source.Successors.FindByPredicate([&Key](const FSuccessor& Candidate) { return Candidate.Key == Key; });
+			if (Successor == nullptr)
+			{
+				if (Source.Successors.Num() >= MaxSuccessors)
+				{
+					//Make room by dropping the rarest move
+					int32 Rarest = 0;
+					for (int32 Index = 1; Index < Source.Successors.Num(); ++Index)
+					{
+						if (Source.Successors[Index].Count < Source.Successors[Rarest].Count) Rarest = Index;
+					}
+					Source.Total -= Source.Successors[Rarest].Count;
+					Source.Successors.RemoveAtSwap(Rarest);
+				}
+				Successor = &Source.Successors.AddDefaulted_GetRef();
+				Successor->Key = Key;
+			}
+			Successor->View = View;
+			Successor->Count += 1.f;
+			Source.Total += 1.f;
+			if (Source.Total > MaxTotal)
+			{
+				Source.Total = 0.f;
+				for (FSuccessor& Aged : Source.Successors)
+				{
+					Aged.Count *= 0.5f;
+					Source.Total += Aged.Count;
+				}
+			}
+		}
+		PreviousKey = Key;
+	}
+
+	//Likeliest views after Key, likeliest first. Only views that followed it at least MinProbability of the time
+	void Predict(const FString& Key, int32 MaxResults, float MinProbability, TArray<ViewType>& OutViews) const
+	{
+		OutViews.Reset();
+		const FSource* Source = Sources.Find(Key);
+		if (Source == nullptr || Source->Total <= 0.f || MaxResults <= 0) return;
+		TArray<const FSuccessor*, TInlineAllocator<MaxSuccessors>> Ranked;
+		for (const FSuccessor& Successor : Source->Successors)
+		{
+			if (Successor.Count >= MinProbability * Source->Total)
+			{
+				Ranked.Add(&Successor);
+			}
+		}
+		Ranked.Sort([](const FSuccessor& A, const FSuccessor& B) { return A.Count > B.Count; });
+		for (int32 Index = 0; Index < FMath::Min(MaxResults, Ranked.Num()); ++Index)
+		{
+			OutViews.Add(Ranked[Index]->View);
+		}
+	}
+
+	void Empty()
+	{
+		Sources.Empty();
+		PreviousKey.Reset();
+	}
+
+private:
+	struct FSuccessor
+	{
+		FString Key;
+		ViewType View;
+		float Count = 0.f;
+	};
+
+	struct FSource
+	{
+		TArray<FSuccessor, TInlineAllocator<MaxSuccessors>> Successors;
+		float Total = 0.f;
+		double LastUsedTime = 0.0;
+	};
+
+	FSource& FindOrAddSource(const FString& Key)
+	{
+		if (!Sources.Contains(Key) && Sources.Num() >= MaxViews)
+		{
+			const FString* Oldest = nullptr;
+			double OldestTime = 0.0;
+			for (const TPair<FString, FSource>& Pair : Sources)
+			{
+				if (Oldest == nullptr || Pair.Value.LastUsedTime < OldestTime)
+				{
+					Oldest = &Pair.Key;
+					OldestTime = Pair.Value.LastUsedTime;
+				}
+			}
+			Sources.Remove(FString(*Oldest));
+		}
+		FSource& Source = Sources.FindOrAdd(Key);
+		Source.LastUsedTime = FPlatformTime::Seconds();
+		return Source;
+	}
+
+	TMap<FString, FSource> Sources;
+	FString PreviousKey;
+};
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeaderboardController.h"
+
+/**
+ * Best known score of one player per topic and period. Values seeded from boards are exact, values from the
+ * player's own posts are lower bounds; either way a score that does not beat them cannot change a best-per-player board.
+ * A best only counts for the period window (UTC day, week, month) it was seen in. Game thread only.
+ * Nothing is ruled out for a topic until a board has told which way it sorts, nor once the topic was shown with
+ * bIncludeAllUsersScores, where every post gets its own row.
+ */
+class MONA_API_LEADERBOARD_API FLeaderboardPersonalBests
+{
+public:
+	//The player's rows on a board fetched for Query. Custom start/end time boards say nothing about a period
+	void SeedFromBoard(const FLeaderboardQuery& Query, const FScores& Board, const FString& Username, const FDateTime& Now);
+
+	//A successful post counts towards every period. Until a board taught the topic's order these are only kept, not compared
+	void RecordPost(const FString& Topic, double Score, const FDateTime& Now);
+
+	//False only if the topic's order is known, no board of it keeps every score, every period has a best for its
+	//current window and Score beats none of them
+	bool WouldImprove(const FString& Topic, double Score, const FDateTime& Now) const;
+
+	bool GetBest(const FString& Topic, ELeaderboardPeriod Period, const FDateTime& Now, double& OutScore) const;
+
+	void Empty() { Topics.Empty(); }
+
+private:
+	static constexpr int32 NumPeriods = static_cast<int32>(ELeaderboardPeriod::all_time) + 1;
+
+	struct FBest
+	{
+		double Score = 0.0;
+		FDateTime WindowStart;
+		bool bKnown = false;
+	};
+
+	struct FTopicBests
+	{
+		ELeaderboardSortingOrder Order = ELeaderboardSortingOrder::highest;
+		//Set by SeedFromBoard only, Order is a guess before that
+		bool bOrderKnown = false;
+		//Seen with bIncludeAllUsersScores, so any post shows up somewhere
+		bool bKeepsEveryScore = false;
+		FBest Periods[NumPeriods];
+	};
+
+	static bool IsBetter(ELeaderboardSortingOrder Order, double Score, double Than);
+	static const FBest* FindCurrent(const FTopicBests& Bests, ELeaderboardPeriod Period, const FDateTime& Now);
+	static void Offer(FTopicBests& Bests, ELeaderboardPeriod Period, double Score, const FDateTime& Now);
+
+	TMap<FString, FTopicBests> Topics;
+};
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Containers/Ticker.h"
+#include "LeaderboardController.h"
+#include "LeaderboardPlayerComponent.generated.h"
+
+class APlayerController;
+class ULeaderboardSession;
+
+//One player's score at the end of a match
+USTRUCT(BlueprintType)
+struct FLeaderboardMatchResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category= "Leaderboard")
+	TObjectPtr<APlayerController> Player = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category= "Leaderboard")
+	float Score = 0.f;
+};
+
+//Outcome of the last server-side submission, replicated to the owning client
+USTRUCT(BlueprintType)
+struct FLeaderboardSubmissionResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category= "Leaderboard")
+	bool bSuccess = false;
+
+	//The score was not sent, see ULeaderboardController::NonImprovingScores. bSuccess is false
+	UPROPERTY(BlueprintReadOnly, Category= "Leaderboard")
+	bool bSkipped = false;
+
+	UPROPERTY(BlueprintReadOnly, Category= "Leaderboard")
+	float Score = 0.f;
+
+	//Only meaningful with bRankKnown. -1 (INDEX_NONE) when the player did not make the fetched top scores.
+	//Unknown, not -1, while the server has not resolved the player's username
+	UPROPERTY(BlueprintReadOnly, Category= "Leaderboard")
+	int32 Rank = 0;
+
+	//False when the post failed or the board fetched for ranks after it did; the score itself may still be in
+	UPROPERTY(BlueprintReadOnly, Category= "Leaderboard")
+	bool bRankKnown = false;
+
+	//Bumped per submission so an identical result still replicates
+	UPROPERTY()
+	uint8 Serial = 0;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLeaderboardSubmissionResult, const FLeaderboardSubmissionResult&, Result);
+
+/**
+ * A player's leaderboard identity on a dedicated server. Add it to the PlayerController.
+ * The client hands its tokens to the server once after logging in (RegisterWithServer). After that the server
+ * posts the player's scores itself, signed with a secret only the server holds (-MonaSDKSecret= or MONA_SDK_SECRET),
+ * and the result replicates back to the owning client. Clients do no HTTP work at match end.
+ */
+UCLASS(ClassGroup=(Leaderboard), meta=(BlueprintSpawnableComponent))
+class MONA_API_LEADERBOARD_API ULeaderboardPlayerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+public:
+	ULeaderboardPlayerComponent();
+
+	//Client: send the default session's tokens to the server
+	UFUNCTION(BlueprintCallable, Category= "Leaderboard")
+	void RegisterWithServer();
+
+	UFUNCTION(Server, Reliable)
+	void ServerRegisterTokens(const FString& AccessToken, const FString& RefreshToken);
+
+	//Server: posts every registered player's score through the scheduler, then resolves all ranks with a single
+	//top-scores fetch and replicates each player's result. Players without a registered component fail
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category= "Leaderboard")
+	static void SubmitMatchResults(const TArray<FLeaderboardMatchResult>& Results, const FString& Topic = "");
+
+	UFUNCTION(BlueprintPure, Category= "Leaderboard")
+	bool IsRegistered() const { return ServerSession != nullptr; }
+
+	//Server only, null until the client registered
+	ULeaderboardSession* GetServerSession() const { return ServerSession; }
+
+	UPROPERTY(ReplicatedUsing=OnRep_LastResult, BlueprintReadOnly, Category= "Leaderboard")
+	FLeaderboardSubmissionResult LastResult;
+
+	//Fires on the owning client, and on the server when the result is set
+	UPROPERTY(BlueprintAssignable, Category= "Leaderboard")
+	FOnLeaderboardSubmissionResult OnSubmissionResult;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	FString MakePlayerID() const;
+	//Resolves the session's username, which ranks are matched on. Retries with backoff, logs when it gives up
+	void RequestServerUser(int32 Attempt);
+	//Rank is 1-based, INDEX_NONE if not on the fetched board, 0 if there was no board or username to look at
+	void SetResult(bool bSuccess, float Score, int32 Rank, bool bSkipped = false);
+
+	UFUNCTION()
+	void OnRep_LastResult();
+
+	UPROPERTY(Transient)
+	TObjectPtr<ULeaderboardSession> ServerSession;
+
+	FString ServerPlayerID;
+
+	static constexpr int32 MaxUserLookupAttempts = 4;
+	FTSTicker::FDelegateHandle UserRetryHandle;
+	bool bUserLookupPending = false;
+};
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/List.h"
+#include "LeaderboardMemory.h"
+#include "LeaderboardProfileCache.generated.h"
+
+//Public profile of a leaderboard user, keyed by username
+USTRUCT(BlueprintType)
+struct FLeaderboardProfile
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Score Info")
+	FString Username;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Score Info")
+	FString Name;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Score Info")
+	FString Avatar_Url;
+};
+
+/**
+ * Least-recently-used profile store bounded by an approximate byte budget rather than an entry count,
+ * since names and avatar URLs vary widely in length. Game thread only.
+ */
+class MONA_API_LEADERBOARD_API FLeaderboardProfileCache : public ILeaderboardMemoryPool
+{
+public:
+	explicit FLeaderboardProfileCache(int64 InBudgetBytes = 256 * 1024) : BudgetBytes(InBudgetBytes) {}
+	~FLeaderboardProfileCache() { Empty(); }
+
+	FLeaderboardProfileCache(const FLeaderboardProfileCache&) = delete;
+	FLeaderboardProfileCache& operator=(const FLeaderboardProfileCache&) = delete;
+
+	//Marks the profile most recently used
+	const FLeaderboardProfile* Find(const FString& Username);
+	bool Contains(const FString& Username) const { return Entries.Contains(Username); }
+
+	//Replaces any previous profile for the same username, then evicts down to the budget
+	void Store(const FLeaderboardProfile& Profile);
+	void Remove(const FString& Username);
+	void Empty();
+
+	void SetBudgetBytes(int64 InBudgetBytes);
+	int64 GetBudgetBytes() const { return BudgetBytes; }
+	int32 Num() const { return Entries.Num(); }
+
+	//Find calls that did and did not return a profile
+	int32 GetNumHits() const { return NumHits; }
+	int32 GetNumMisses() const { return NumMisses; }
+
+	//Relative to one board fetch, used when the shared memory budget picks what to evict
+	void SetRefetchCost(double InRefetchCost) { RefetchCost = InRefetchCost; }
+
+	//ILeaderboardMemoryPool
+	virtual const TCHAR* GetPoolName() const override { return TEXT("Profiles"); }
+	virtual int64 GetUsedBytes() const override { return UsedBytes; }
+	virtual bool GetEvictionCandidate(double& OutScore) const override;
+	virtual void EvictCandidate() override;
+
+private:
+	using FRecencyList = TDoubleLinkedList<FString>;
+
+	struct FEntry
+	{
+		FLeaderboardProfile Profile;
+		FRecencyList::TDoubleLinkedListNode* Node = nullptr;
+		int64 Bytes = 0;
+		double LastUsedTime = 0.0;
+	};
+
+	static int64 GetEntryBytes(const FString& Key, const FLeaderboardProfile& Profile);
+	void EvictToBudget();
+
+	TMap<FString, FEntry> Entries;
+	//Head is the most recently used
+	FRecencyList Recency;
+	int64 BudgetBytes;
+	int64 UsedBytes = 0;
+	double RefetchCost = 1.0;
+	int32 NumHits = 0;
+	int32 NumMisses = 0;
+};
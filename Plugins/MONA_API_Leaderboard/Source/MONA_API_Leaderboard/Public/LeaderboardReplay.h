@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "LeaderboardTransport.h"
+
+//One request and the response it got. Secrets are redacted before they are stored
+struct MONA_API_LEADERBOARD_API FLeaderboardRecordedExchange
+{
+	FString Verb;
+	FString URL;
+	TArray<FString> RequestHeaders;
+	TArray<uint8> RequestBody;
+
+	//0 when the request never got a response
+	int32 Code = 0;
+	TArray<FString> ResponseHeaders;
+	TArray<uint8> ResponseBody;
+
+	//Seconds since recording started, and from dispatch to completion
+	double StartOffset = 0.0;
+	double Duration = 0.0;
+
+	friend FArchive& operator<<(FArchive& Ar, FLeaderboardRecordedExchange& Exchange);
+};
+
+/**
+ * Captured controller traffic. Stored as a small header followed by the zlib-compressed exchanges.
+ */
+struct MONA_API_LEADERBOARD_API FLeaderboardRecording
+{
+	TArray<FLeaderboardRecordedExchange> Exchanges;
+
+	bool SaveToFile(const FString& Path) const;
+	bool LoadFromFile(const FString& Path);
+
+	//Drops Authorization/cookie headers and replaces token, OTP, signature and email fields in JSON bodies
+	static void RedactHeaders(TArray<FString>& Headers);
+	static void RedactBody(TArray<uint8>& Body);
+};
+
+/**
+ * Passes every request on to another transport and records it together with its response.
+ */
+class MONA_API_LEADERBOARD_API FLeaderboardRecordingTransport : public ILeaderboardTransport
+{
+public:
+	explicit FLeaderboardRecordingTransport(const TSharedRef<ILeaderboardTransport>& InInner);
+
+	virtual void Send(const FHttpRequestRef& Request, TFunction<void(const FLeaderboardHttpResponse&)>&& OnComplete) override;
+	virtual void Cancel(const FHttpRequestRef& Request) override;
+
+	//Completed exchanges in completion order. Cancelled requests are not recorded
+	const FLeaderboardRecording& GetRecording() const { return *Recording; }
+	const TSharedRef<ILeaderboardTransport>& GetInner() const { return Inner; }
+
+private:
+	TSharedRef<ILeaderboardTransport> Inner;
+	TSharedRef<FLeaderboardRecording> Recording;
+	double RecordingStartTime;
+};
+
+/**
+ * Answers requests from a recording instead of the network. Requests are matched to exchanges by verb and URL,
+ * first recorded first served; once a URL's exchanges are used up its last one keeps being served, so polling
+ * keeps working. A request that was never recorded fails as if the connection had.
+ * Responses arrive after the recorded duration divided by Speed; Speed <= 0 answers on the next tick.
+ */
+class MONA_API_LEADERBOARD_API FLeaderboardReplayTransport : public ILeaderboardTransport, public TSharedFromThis<FLeaderboardReplayTransport>
+{
+public:
+	FLeaderboardReplayTransport(const FLeaderboardRecording& Recording, float InSpeed = 1.f);
+	virtual ~FLeaderboardReplayTransport() override;
+
+	virtual void Send(const FHttpRequestRef& Request, TFunction<void(const FLeaderboardHttpResponse&)>&& OnComplete) override;
+	virtual void Cancel(const FHttpRequestRef& Request) override;
+
+	void SetSpeed(float InSpeed) { Speed = InSpeed; }
+	float GetSpeed() const { return Speed; }
+
+	int32 GetNumUnmatched() const { return NumUnmatched; }
+
+private:
+	struct FExchangeQueue
+	{
+		TArray<FLeaderboardRecordedExchange> Exchanges;
+		int32 Next = 0;
+	};
+
+	static FString MakeKey(const FString& Verb, const FString& URL);
+
+	TMap<FString, FExchangeQueue> Queues;
+	TMap<const IHttpRequest*, FTSTicker::FDelegateHandle> Pending;
+	float Speed = 1.f;
+	int32 NumUnmatched = 0;
+};
@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "LeaderboardController.h"
+#include "LeaderboardReplicator.generated.h"
+
+class ALeaderboardReplicator;
+
+//One board row on the wire. Names are indices into the replicator's interned name table
+USTRUCT()
+struct FLeaderboardReplicatedRow : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 ID = 0;
+
+	UPROPERTY()
+	int32 Rank = 0;
+
+	UPROPERTY()
+	int32 Score = 0;
+
+	UPROPERTY()
+	uint16 UsernameIndex = 0;
+
+	UPROPERTY()
+	uint16 NameIndex = 0;
+};
+
+USTRUCT()
+struct FLeaderboardReplicatedBoard : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FLeaderboardReplicatedRow> Rows;
+
+	//Set by the owning actor, not replicated
+	ALeaderboardReplicator* Owner = nullptr;
+
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FLeaderboardReplicatedRow, FLeaderboardReplicatedBoard>(Rows, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FLeaderboardReplicatedBoard> : public TStructOpsTypeTraitsBase2<FLeaderboardReplicatedBoard>
+{
+	enum { WithNetDeltaSerializer = true };
+};
+
+//Counts a replicator's interned name table against the controller's memory budget
+class FLeaderboardNameTablePool : public ILeaderboardMemoryPool
+{
+public:
+	const ALeaderboardReplicator* Owner = nullptr;
+
+	virtual const TCHAR* GetPoolName() const override { return TEXT("Replicated names"); }
+	virtual int64 GetUsedBytes() const override;
+};
+
+/**
+ * Fetches a board once on the server and replicates it to every client. Only rows whose rank or score changed
+ * are sent, and each distinct username/name crosses the wire once. Backend load and client bandwidth stay flat
+ * however many players watch the board. Place one in the level (or spawn it on the server) per board.
+ */
+UCLASS()
+class MONA_API_LEADERBOARD_API ALeaderboardReplicator : public AInfo
+{
+	GENERATED_BODY()
+public:
+	ALeaderboardReplicator();
+
+	//Server: fetch Query now and every RefreshInterval seconds. Unchanged boards (304) cost nothing to replicate
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category= "Leaderboard")
+	void StartServerBoard(const FLeaderboardQuery& Query, float RefreshInterval = 10.f);
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category= "Leaderboard")
+	void StopServerBoard();
+
+	//Server: replicate this board. Diffs against the previous one by row ID
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category= "Leaderboard")
+	void SetBoard(const FScores& InBoard);
+
+	//Latest board, sorted by rank. Created_At and Topic are not replicated
+	UFUNCTION(BlueprintPure, Category= "Leaderboard")
+	const FScores& GetBoard() const { return Board; }
+
+	//First replicator in the world, if any
+	UFUNCTION(BlueprintPure, Category= "Leaderboard", meta=(WorldContext="WorldContextObject"))
+	static ALeaderboardReplicator* FindReplicator(const UObject* WorldContextObject);
+
+	//Fires on clients whenever a replicated update changed the board, and on the server when SetBoard changed it
+	UPROPERTY(BlueprintAssignable, Category= "Leaderboard")
+	FOnTopScoresReceived OnBoardChanged;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostInitProperties() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	friend struct FLeaderboardReplicatedBoard;
+	friend class FLeaderboardNameTablePool;
+
+	void FetchServerBoard();
+	uint16 InternName(const FString& Name);
+	void CompactNames();
+	void RebuildBoard();
+
+	UFUNCTION()
+	void OnRep_Names();
+
+	//Append-only between compactions, so only new names are sent
+	UPROPERTY(ReplicatedUsing=OnRep_Names)
+	TArray<FString> Names;
+
+	UPROPERTY(Replicated)
+	FLeaderboardReplicatedBoard ReplicatedBoard;
+
+	FScores Board;
+	TMap<FString, uint16> NameIndices;
+	//Rows arrived before the names they refer to
+	bool bAwaitingNames = false;
+	int32 NumNamesSeen = 0;
+	FLeaderboardNameTablePool NameTablePool;
+
+	FLeaderboardQuery ServerQuery;
+	FTimerHandle RefreshTimer;
+	FLeaderboardRequestHandle FetchHandle;
+	bool bFetchInFlight = false;
+};
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "LeaderboardTransport.h"
+#include "LeaderboardStats.h"
+#include "LeaderboardMemory.h"
+#include "LeaderboardRequestScheduler.generated.h"
+
+//Priority classes, highest first. Requests of a higher class are always dispatched before lower ones
+UENUM(BlueprintType)
+enum class ELeaderboardRequestPriority : uint8
+{
+	Auth,
+	ScorePost,
+	VisibleBoard,
+	Prefetch,
+	Count UMETA(Hidden)
+};
+
+//Opaque handle to a scheduled request, used to cancel it
+USTRUCT(BlueprintType)
+struct FLeaderboardRequestHandle
+{
+	GENERATED_BODY()
+
+	uint64 ID = 0;
+
+	bool IsValid() const { return ID != 0; }
+	void Invalidate() { ID = 0; }
+
+	bool operator==(const FLeaderboardRequestHandle& Other) const { return ID == Other.ID; }
+};
+
+//Every response the scheduler hands on, before its completion delegate runs. QueueSeconds is the time the request
+//waited for a free slot, Response.Latency the round trip after that
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnLeaderboardResponseObserved, ELeaderboardEndpoint /*Endpoint*/, const FLeaderboardHttpResponse& /*Response*/, double /*QueueSeconds*/);
+
+/**
+ * Central dispatcher for every HTTP request the leaderboard plugin makes.
+ * Requests are queued per priority class and at most MaxConcurrentRequests are in flight at once.
+ * Cancelled requests never reach their completion delegate.
+ * Dispatch goes through an ILeaderboardTransport, the engine HTTP module unless replaced.
+ * Game thread only.
+ */
+class MONA_API_LEADERBOARD_API FLeaderboardRequestScheduler : public ILeaderboardMemoryPool
+{
+public:
+	FLeaderboardRequestScheduler();
+	~FLeaderboardRequestScheduler();
+
+	FLeaderboardRequestScheduler(const FLeaderboardRequestScheduler&) = delete;
+	FLeaderboardRequestScheduler& operator=(const FLeaderboardRequestScheduler&) = delete;
+
+	//Dispatches the request when a slot is free. Any OnProcessRequestComplete binding on it is ignored.
+	//Endpoint is only used to attribute stats
+	FLeaderboardRequestHandle Submit(const FHttpRequestRef& Request, ELeaderboardEndpoint Endpoint, ELeaderboardRequestPriority Priority, FLeaderboardResponseDelegate OnComplete);
+
+	//Returns true if the request was still queued or in flight. Its completion delegate will not fire
+	bool Cancel(FLeaderboardRequestHandle Handle);
+
+	void CancelAll();
+
+	void SetMaxConcurrentRequests(int32 InMaxConcurrentRequests);
+	int32 GetMaxConcurrentRequests() const { return MaxConcurrentRequests; }
+
+	int32 GetNumQueued() const;
+	int32 GetNumQueued(ELeaderboardRequestPriority Priority) const { return Queues[static_cast<int32>(Priority)].Num(); }
+	int32 GetNumInFlight() const { return InFlight.Num(); }
+
+	//Applies to requests dispatched from now on
+	void SetTransport(const TSharedRef<ILeaderboardTransport>& InTransport) { Transport = InTransport; }
+	const TSharedRef<ILeaderboardTransport>& GetTransport() const { return Transport; }
+
+	FLeaderboardStats& GetStats() { return Stats; }
+
+	FOnLeaderboardResponseObserved OnResponseObserved;
+
+	//ILeaderboardMemoryPool. Bodies of queued and in-flight requests, never evictable
+	virtual const TCHAR* GetPoolName() const override { return TEXT("Request bodies"); }
+	virtual int64 GetUsedBytes() const override;
+
+private:
+	struct FScheduledRequest
+	{
+		uint64 ID = 0;
+		ELeaderboardEndpoint Endpoint = ELeaderboardEndpoint::Count;
+		FHttpRequestPtr Request;
+		FLeaderboardResponseDelegate OnComplete;
+		TSharedPtr<ILeaderboardTransport> Transport;
+		double SubmitTime = 0.0;
+		//Set at dispatch
+		double QueueSeconds = 0.0;
+	};
+
+	void Pump();
+	void Dispatch(FScheduledRequest&& Scheduled);
+	void HandleRequestComplete(const FLeaderboardHttpResponse& Response, uint64 ID);
+
+	TArray<FScheduledRequest> Queues[static_cast<int32>(ELeaderboardRequestPriority::Count)];
+	TMap<uint64, FScheduledRequest> InFlight;
+	TSharedRef<ILeaderboardTransport> Transport;
+	FLeaderboardStats Stats;
+
+	int32 MaxConcurrentRequests = 4;
+	uint64 NextID = 1;
+};
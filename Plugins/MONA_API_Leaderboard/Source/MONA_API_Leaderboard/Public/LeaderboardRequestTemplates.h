@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+
+enum class ELeaderboardEndpoint : uint8
+{
+	GenerateOTP,
+	VerifyOTP,
+	RefreshToken,
+	PostScore,
+	GetUser,
+	TopScores,
+	Profiles,
+	TopScoresBatch,
+	Count
+};
+
+MONA_API_LEADERBOARD_API const TCHAR* LexToString(ELeaderboardEndpoint Endpoint);
+//Case-insensitive, false for unknown names
+MONA_API_LEADERBOARD_API bool LexTryParseString(ELeaderboardEndpoint& OutEndpoint, const TCHAR* Name);
+
+//Verb, URL and constant headers of one endpoint, computed once per base URL / application ID
+struct MONA_API_LEADERBOARD_API FLeaderboardRequestTemplate
+{
+	FString Verb;
+	FString URL;
+	TArray<TPair<FString, FString>> Headers;
+
+	//New request with everything but the per-call fields filled in
+	FHttpRequestRef Instantiate() const;
+};
+
+class MONA_API_LEADERBOARD_API FLeaderboardRequestTemplates
+{
+public:
+	//Call whenever the base URL, application ID, profiles path or batch path changes
+	void Rebuild(const FString& BaseURL, const FString& ApplicationID, const FString& ProfilesPath, const FString& TopScoresBatchPath);
+
+	const FLeaderboardRequestTemplate& Get(ELeaderboardEndpoint Endpoint) const { return Templates[static_cast<int32>(Endpoint)]; }
+
+	//Top-scores URL up to and including the '?' of the query string
+	const FString& GetTopScoresURLPrefix() const { return Get(ELeaderboardEndpoint::TopScores).URL; }
+
+private:
+	FLeaderboardRequestTemplate Templates[static_cast<int32>(ELeaderboardEndpoint::Count)];
+};
+
+//Small JSON bodies are written straight into a stack string builder instead of going through FJsonObject.
+//Responses are read with the helpers in LeaderboardJsonParse.h
+namespace LeaderboardJson
+{
+	MONA_API_LEADERBOARD_API void AppendEscaped(FStringBuilderBase& Builder, FStringView Value);
+
+	//Starts '{' on first use and ',' afterwards
+	MONA_API_LEADERBOARD_API void AppendStringField(FStringBuilderBase& Builder, const TCHAR* Name, FStringView Value);
+	MONA_API_LEADERBOARD_API void AppendNumberField(FStringBuilderBase& Builder, const TCHAR* Name, double Value);
+
+	//Closes the object and moves it into the request as UTF-8
+	MONA_API_LEADERBOARD_API void SetContent(const FHttpRequestRef& Request, FStringBuilderBase& Builder);
+}
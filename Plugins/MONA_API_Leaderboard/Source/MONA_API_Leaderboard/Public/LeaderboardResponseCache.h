@@ -0,0 +1,198 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "LeaderboardTransport.h"
+#include "LeaderboardMemory.h"
+
+//HTTP cache validators remembered from a response and replayed on the next request for the same resource
+struct FLeaderboardValidators
+{
+	FString ETag;
+	FString LastModified;
+
+	bool IsEmpty() const { return ETag.IsEmpty() && LastModified.IsEmpty(); }
+
+	static FLeaderboardValidators FromResponse(const FLeaderboardHttpResponse& Response)
+	{
+		FLeaderboardValidators Validators;
+		if (Response.IsValid())
+		{
+			Validators.ETag = Response.GetHeader(TEXT("ETag"));
+			Validators.LastModified = Response.GetHeader(TEXT("Last-Modified"));
+		}
+		return Validators;
+	}
+
+	//Turns the request into a conditional GET, the server answers 304 with no body if nothing changed
+	void ApplyTo(const FHttpRequestRef& Request) const
+	{
+		if (!ETag.IsEmpty())
+		{
+			Request->SetHeader(TEXT("If-None-Match"), ETag);
+		}
+		if (!LastModified.IsEmpty())
+		{
+			Request->SetHeader(TEXT("If-Modified-Since"), LastModified);
+		}
+	}
+};
+
+/**
+ * Parsed responses keyed by request URL, together with the validators needed to revalidate them.
+ * A 304 answer reuses the stored value without touching the (empty) body.
+ * ValueType needs a GetLeaderboardAllocatedSize overload for memory accounting.
+ */
+template<typename ValueType>
+class TLeaderboardResponseCache : public ILeaderboardMemoryPool
+{
+public:
+	struct FEntry
+	{
+		FLeaderboardValidators Validators;
+		ValueType Value;
+		double StoredTime = 0.0;
+		mutable double LastUsedTime = 0.0;
+		int64 Bytes = 0;
+		//FPlatformTime seconds after which the value is no longer current, 0 for never
+		double ExpiresTime = 0.0;
+
+		bool IsExpired(double Now) const { return ExpiresTime > 0.0 && Now >= ExpiresTime; }
+	};
+
+	explicit TLeaderboardResponseCache(const TCHAR* InPoolName = TEXT("Responses"), double InRefetchCost = 1.0)
+		: PoolName(InPoolName)
+		, RefetchCost(InRefetchCost)
+	{
+	}
+
+	//Expired entries are never returned
+	const FEntry* Find(const FString& URL) const
+	{
+		const FEntry* Entry = Entries.Find(URL);
+		const double Now = FPlatformTime::Seconds();
+		if (Entry == nullptr || Entry->IsExpired(Now)) return nullptr;
+		Entry->LastUsedTime = Now;
+		return Entry;
+	}
+
+	//Only responses that carry validators are worth keeping, anything else can never be revalidated.
+	//TimeToLive > 0 expires the entry that many seconds from now
+	void Store(const FString& URL, const FLeaderboardValidators& Validators, const ValueType& Value, double TimeToLive = 0.0)
+	{
+		if (Validators.IsEmpty())
+		{
+			Remove(URL);
+			return;
+		}
+		FEntry& Entry = Entries.FindOrAdd(URL);
+		Entry.Validators = Validators;
+		Entry.Value = Value;
+		Entry.StoredTime = FPlatformTime::Seconds();
+		Entry.LastUsedTime = Entry.StoredTime;
+		Entry.ExpiresTime = TimeToLive > 0.0 ? Entry.StoredTime + TimeToLive : 0.0;
+		UsedBytes -= Entry.Bytes;
+		Entry.Bytes = sizeof(FEntry) + URL.GetAllocatedSize() + Validators.ETag.GetAllocatedSize()
+			+ Validators.LastModified.GetAllocatedSize() + GetLeaderboardAllocatedSize(Value);
+		UsedBytes += Entry.Bytes;
+		NotifyGrew();
+	}
+
+	//The server confirmed the value (304), it counts as stored now
+	void MarkRevalidated(const FString& URL)
+	{
+		if (FEntry* Entry = Entries.Find(URL))
+		{
+			Entry->StoredTime = FPlatformTime::Seconds();
+		}
+	}
+
+	void ApplyValidators(const FString& URL, const FHttpRequestRef& Request) const
+	{
+		const FEntry* Entry = Entries.Find(URL);
+		if (Entry && !Entry->IsExpired(FPlatformTime::Seconds()))
+		{
+			Entry->Validators.ApplyTo(Request);
+		}
+	}
+
+	void Remove(const FString& URL)
+	{
+		FEntry Entry;
+		if (Entries.RemoveAndCopyValue(URL, Entry))
+		{
+			UsedBytes -= Entry.Bytes;
+		}
+	}
+
+	//Predicate(const FString& URL). Returns how many entries went
+	template<typename PredicateType>
+	int32 RemoveIf(PredicateType&& Predicate)
+	{
+		int32 NumRemoved = 0;
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			if (Predicate(It.Key()))
+			{
+				UsedBytes -= It.Value().Bytes;
+				It.RemoveCurrent();
+				++NumRemoved;
+			}
+		}
+		return NumRemoved;
+	}
+
+	void Empty()
+	{
+		Entries.Empty();
+		UsedBytes = 0;
+	}
+
+	int32 Num() const { return Entries.Num(); }
+
+	//Func(const FString& URL, const FEntry& Entry). Does not count as a use for eviction
+	template<typename FuncType>
+	void ForEach(FuncType&& Func) const
+	{
+		for (const TPair<FString, FEntry>& Pair : Entries)
+		{
+			Func(Pair.Key, Pair.Value);
+		}
+	}
+
+	//ILeaderboardMemoryPool
+	virtual const TCHAR* GetPoolName() const override { return PoolName; }
+	virtual int64 GetUsedBytes() const override { return UsedBytes; }
+
+	virtual bool GetEvictionCandidate(double& OutScore) const override
+	{
+		CandidateURL.Reset();
+		const double Now = FPlatformTime::Seconds();
+		for (const TPair<FString, FEntry>& Pair : Entries)
+		{
+			//Expired entries are dead weight, they go first
+			const double Score = Pair.Value.IsExpired(Now) ? TNumericLimits<double>::Max() : ScoreEntry(Pair.Value.Bytes, RefetchCost, Pair.Value.LastUsedTime);
+			if (CandidateURL.IsEmpty() || Score > OutScore)
+			{
+				CandidateURL = Pair.Key;
+				OutScore = Score;
+			}
+		}
+		return !CandidateURL.IsEmpty();
+	}
+
+	virtual void EvictCandidate() override
+	{
+		Remove(CandidateURL);
+		CandidateURL.Reset();
+	}
+
+private:
+	TMap<FString, FEntry> Entries;
+	const TCHAR* PoolName;
+	double RefetchCost;
+	int64 UsedBytes = 0;
+	mutable FString CandidateURL;
+};
@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "LeaderboardController.h"
+#include "LeaderboardCredentials.h"
+#include "LeaderboardPersonalBest.h"
+#include "LeaderboardSession.generated.h"
+
+/**
+ * One player's identity against the MONA API: its own access/refresh tokens and its own queue of
+ * requests waiting on a token refresh. Transport, caches and the signing secret are shared through
+ * the owning ULeaderboardController, so any number of sessions can post concurrently.
+ */
+UCLASS(BlueprintType)
+class MONA_API_LEADERBOARD_API ULeaderboardSession : public UObject
+{
+	GENERATED_BODY()
+public:
+	//Authorization
+	UFUNCTION(BlueprintCallable, Category= "Authorization")
+	void GenerateOTP(const FString& Email);
+
+	UFUNCTION(BlueprintCallable, Category= "Authorization")
+	void VerifyOTP(const FString& Email, const FString& OTP);
+
+	//Only one refresh is in flight per session, further calls while it is pending are ignored
+	UFUNCTION(BlueprintCallable, Category= "Authorization")
+	void RefreshAccessToken();
+
+	//Adopt tokens obtained elsewhere, e.g. handed over by the owning client
+	UFUNCTION(BlueprintCallable, Category= "Authorization")
+	void SetTokens(const FString& InAccessToken, const FString& InRefreshToken);
+
+	UFUNCTION(BlueprintCallable, Category= "Authorization")
+	void GetUser();
+
+	//Leaderboard
+	UFUNCTION(BlueprintCallable, Category= "LeaderboardController")
+	void PostScore(const float Score, const FString& Topic = "");
+
+	//Native per-call API. Results reach only the callback (or future), no delegates are fired
+	void GenerateOTPAsync(const FString& Email, FOnLeaderboardRequestComplete OnComplete);
+	void VerifyOTPAsync(const FString& Email, const FString& OTP, FOnLeaderboardRequestComplete OnComplete);
+	void PostScoreAsync(const float Score, const FString& Topic, FOnLeaderboardRequestComplete OnComplete);
+	//Tells a post skipped by NonImprovingScores apart from a failed one
+	void PostScoreAsync(const float Score, const FString& Topic, FOnScorePostComplete OnComplete);
+	void GetUserAsync(FOnUserComplete OnComplete);
+
+	TFuture<bool> GenerateOTPAsync(const FString& Email);
+	TFuture<bool> VerifyOTPAsync(const FString& Email, const FString& OTP);
+	TFuture<bool> PostScoreAsync(const float Score, const FString& Topic);
+	TFuture<TOptional<FUser>> GetUserAsync();
+
+	UFUNCTION(BlueprintPure, Category= "LeaderboardController")
+	const FString& GetPlayerID() const { return PlayerID; }
+
+	//Best score known for the current window of Period, false if none is known
+	UFUNCTION(BlueprintPure, Category= "LeaderboardController")
+	bool GetPersonalBest(const FString& Topic, ELeaderboardPeriod Period, float& OutScore) const;
+
+	FLeaderboardPersonalBests& GetPersonalBests() { return PersonalBests; }
+
+	UFUNCTION(BlueprintPure, Category= "Authorization")
+	bool IsAuthorized() const;
+
+	//False while not logged in. Used to hand a client's tokens to the server
+	bool GetTokens(FString& OutAccessToken, FString& OutRefreshToken) const;
+
+	bool ValidAuthorization() const;
+
+	//Pure decoders of the auth responses, usable on arbitrary input (see LeaderboardFuzz).
+	//Auth bodies are tiny, anything past MaxAuthResponseBytes is refused unparsed
+	static constexpr int32 MaxAuthResponseBytes = 64 * 1024;
+	//VerifyOTP and refresh bodies. Fields that are missing come back empty; false if the body is not a JSON object
+	static bool ParseTokens(FUtf8StringView Content, FString& OutAccessToken, FString& OutRefreshToken);
+	static bool ParseUser(FUtf8StringView Content, FUser& OutUser);
+
+	//Delegates (Events) for this session only. The controller's default session also fires the controller's delegates
+	UPROPERTY(BlueprintAssignable, Category= "Authorization")
+	FOnOTPVerified OnOtpVerified;
+
+	UPROPERTY(BlueprintAssignable, Category= "Authorization")
+	FOnOTPSent OnOtpSent;
+
+	UPROPERTY(BlueprintAssignable, Category= "LeaderboardController")
+	FOnScorePosted OnScorePosted;
+
+	UPROPERTY(BlueprintAssignable, Category= "LeaderboardController")
+	FOnScoreSkipped OnScoreSkipped;
+
+	UPROPERTY(BlueprintAssignable, Category= "Authorization")
+	FOnUserReceived OnUserReceived;
+
+	//Last user fetched with GetUser
+	UPROPERTY(BlueprintReadOnly, Transient, Category= "Authorization")
+	FUser CurrentUser;
+
+private:
+	friend class ULeaderboardController;
+
+	void Initialize(const FString& InPlayerID) { PlayerID = InPlayerID; }
+
+	ULeaderboardController* GetController() const;
+	bool IsDefaultSession() const;
+
+	void SendScore(const float Score, const FString& Topic, ELeaderboardRequestPriority Priority, bool bRetryOnUnauthorized, FOnLeaderboardRequestComplete OnComplete);
+	//Runs Send(true) now, or once the pending token refresh has finished. Send(false) if that refresh failed
+	void RunAuthorized(TFunction<void(bool bAuthorized)>&& Send);
+	//bConditional sends the cached user's validators
+	void SendGetUser(FOnUserComplete OnComplete, bool bConditional);
+
+	//Response Callbacks
+	void ScorePostedResponseReceived(const FLeaderboardHttpResponse& Response, float Score, FString Topic, ELeaderboardRequestPriority Priority, bool bRetryOnUnauthorized, FOnLeaderboardRequestComplete OnComplete);
+	void GenerateOTPResponseReceived(const FLeaderboardHttpResponse& Response, FOnLeaderboardRequestComplete OnComplete);
+	void VerifyOTPResponseReceived(const FLeaderboardHttpResponse& Response, FOnLeaderboardRequestComplete OnComplete);
+	void GetUserResponseReceived(const FLeaderboardHttpResponse& Response, bool bConditional, FOnUserComplete OnComplete);
+	void RefreshAccessTokenResponseReceived(const FLeaderboardHttpResponse& Response);
+
+	FString PlayerID;
+	//Read from any thread without locking, replaced whole on login and refresh
+	TLeaderboardSnapshot<FLeaderboardCredentials> Credentials;
+
+	bool bRefreshInFlight = false;
+	TArray<TFunction<void(bool bAuthorized)>> AwaitingRefresh;
+
+	TLeaderboardResponseCache<FUser> UserCache{TEXT("User")};
+
+	FLeaderboardPersonalBests PersonalBests;
+};
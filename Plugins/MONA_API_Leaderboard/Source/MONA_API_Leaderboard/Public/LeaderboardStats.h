@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeaderboardRequestTemplates.h"
+#include "LeaderboardTransport.h"
+
+//Counters for one endpoint since the last reset
+struct MONA_API_LEADERBOARD_API FLeaderboardEndpointStats
+{
+	//Requests actually dispatched. Requests cancelled while still queued are not counted
+	int32 NumRequests = 0;
+	//No response, or a 4xx/5xx
+	int32 NumFailed = 0;
+	//Conditional requests the server answered from our cache
+	int32 NumNotModified = 0;
+
+	//Round trip of the most recent response
+	double LastLatency = 0.0;
+
+	int64 TotalResponseBytes = 0;
+	int64 MaxResponseBytes = 0;
+
+	//Time spent in the completion handler on the game thread, including anything it broadcasts to
+	double TotalGameThreadSeconds = 0.0;
+	double MaxGameThreadSeconds = 0.0;
+
+	//Heap bytes the completion handler allocated. Only counted while FLeaderboardAllocationCounter is installed
+	int64 TotalGameThreadAllocatedBytes = 0;
+	int64 MaxGameThreadAllocatedBytes = 0;
+};
+
+//Limits for one endpoint. Unset limits are not checked
+struct MONA_API_LEADERBOARD_API FLeaderboardOperationBudget
+{
+	TOptional<int32> MaxRequests;
+	//Per response, compared against the slowest one
+	TOptional<double> MaxGameThreadMs;
+	//Per response, compared against the largest one
+	TOptional<int64> MaxResponseBytes;
+	//Per response, compared against the handler that allocated the most
+	TOptional<int64> MaxGameThreadAllocatedBytes;
+
+	//Reads "Requests=1 GameThreadMs=2.5 Bytes=20000 AllocatedKB=256" style arguments
+	static FLeaderboardOperationBudget Parse(const TCHAR* Args);
+};
+
+/**
+ * Per-endpoint request counts, response sizes and handler cost, gathered by the scheduler.
+ * The automation tests (Private/Tests) check budgets against it directly; runs that drive the UI
+ * (usually against a replay) can use the Mona.Leaderboard.Stats.* console commands.
+ */
+class MONA_API_LEADERBOARD_API FLeaderboardStats
+{
+public:
+	void RecordRequest(ELeaderboardEndpoint Endpoint);
+	void RecordResponse(ELeaderboardEndpoint Endpoint, const FLeaderboardHttpResponse& Response, double GameThreadSeconds, int64 GameThreadAllocatedBytes);
+
+	const FLeaderboardEndpointStats& Get(ELeaderboardEndpoint Endpoint) const { return Endpoints[static_cast<int32>(Endpoint)]; }
+
+	void Reset();
+
+	//Logs every exceeded limit as an error, so a headless run fails on it
+	bool CheckBudget(ELeaderboardEndpoint Endpoint, const FLeaderboardOperationBudget& Budget) const;
+
+	void Dump() const;
+
+private:
+	FLeaderboardEndpointStats Endpoints[static_cast<int32>(ELeaderboardEndpoint::Count)];
+};
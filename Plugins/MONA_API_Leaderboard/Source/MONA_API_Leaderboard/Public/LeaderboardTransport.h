@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+/**
+ * What the controller sees of an HTTP response. Backed by the live engine response (no copy of the body)
+ * or, for recorded and simulated traffic, by data it owns.
+ */
+struct MONA_API_LEADERBOARD_API FLeaderboardHttpResponse
+{
+	//0 when no response was received (connection failed, request could not be started)
+	int32 Code = 0;
+
+	FString URL;
+
+	//Seconds from dispatch to completion
+	double Latency = 0.0;
+
+	bool IsValid() const { return Code != 0; }
+
+	FString GetHeader(const FString& HeaderName) const;
+	//"Name: Value" pairs, same format as IHttpBase::GetAllHeaders
+	TArray<FString> GetAllHeaders() const;
+
+	TArrayView<const uint8> GetContent() const;
+	//The body as it arrived, for UTF-8 JSON readers. Only valid as long as this response
+	FUtf8StringView GetContentAsUtf8() const;
+	//Converts to TCHAR, prefer GetContentAsUtf8 for parsing
+	FString GetContentAsString() const;
+
+	static FLeaderboardHttpResponse FromHttp(const FHttpRequestPtr& Request, const FHttpResponsePtr& Response, bool bConnectedSuccessfully);
+	static FLeaderboardHttpResponse FromData(const FString& URL, int32 Code, TArray<FString>&& Headers, TArray<uint8>&& Content);
+
+private:
+	FHttpResponsePtr HttpResponse;
+	TArray<FString> OwnedHeaders;
+	TArray<uint8> OwnedContent;
+};
+
+DECLARE_DELEGATE_OneParam(FLeaderboardResponseDelegate, const FLeaderboardHttpResponse&);
+
+/**
+ * Carries requests built by the controller to a backend and hands back responses.
+ * The default transport is the engine HTTP module; recording and replay transports sit in its place.
+ * Game thread only.
+ */
+class MONA_API_LEADERBOARD_API ILeaderboardTransport
+{
+public:
+	virtual ~ILeaderboardTransport() = default;
+
+	//Calls OnComplete exactly once, unless the request is cancelled first
+	virtual void Send(const FHttpRequestRef& Request, TFunction<void(const FLeaderboardHttpResponse&)>&& OnComplete) = 0;
+
+	//OnComplete of a cancelled request never runs
+	virtual void Cancel(const FHttpRequestRef& Request) = 0;
+};
+
+class MONA_API_LEADERBOARD_API FLeaderboardHttpTransport : public ILeaderboardTransport
+{
+public:
+	virtual void Send(const FHttpRequestRef& Request, TFunction<void(const FLeaderboardHttpResponse&)>&& OnComplete) override;
+	virtual void Cancel(const FHttpRequestRef& Request) override;
+};